@@ -1,68 +1,142 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include "outputBuffer.h"
+#include "inlineString.h"
+#include "allocationCounter.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#include <new>
+#include <memory>
+#include <climits>
+#include <string_view>
+#include <charconv>
+#include <cstdio>
+#include <cerrno>
+#include <cctype>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <strings.h>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <typeinfo>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 using namespace std;
 
 class Vehicle {
 private:
     int vehicleID;
-    string manufacturer;
-    string model;
+    InlineString<23> manufacturer; // in place up to the capacity, so a vehicle
+    InlineString<23> model;        // costs no heap blocks of its own
     int year;
     bool active;
 
-    static int totalVehicles;
+    // Live-object count. Vehicles are created and destroyed on many threads,
+    // so each thread keeps its own pending change and adds it to the shared
+    // total once per COUNT_BATCH changes (and when the thread exits) instead
+    // of contending on one counter for every object.
+    static const long COUNT_BATCH = 64;
+    static atomic<long> publishedVehicles;
+    struct PendingCount {
+        long delta = 0;
+        ~PendingCount() { publishedVehicles.fetch_add(delta, memory_order_relaxed); }
+    };
+    static thread_local PendingCount pendingVehicles;
 
-    void ensureActive() { if (!active) { active = true; totalVehicles++; } }
+    static void countChange(long d) {
+        long& pending = pendingVehicles.delta;
+        pending += d;
+        if (pending >= COUNT_BATCH || pending <= -COUNT_BATCH) {
+            publishedVehicles.fetch_add(pending, memory_order_relaxed);
+            pending = 0;
+        }
+    }
+
+    void ensureActive() { if (!active) { active = true; countChange(1); } }
 
 public:
-    Vehicle() : vehicleID(0), manufacturer(""), model(""), year(0), active(false) {}
-    Vehicle(int id, const string& manu, const string& mod, int yr)
+    Vehicle() : vehicleID(0), year(0), active(false) {}
+    Vehicle(int id, string_view manu, string_view mod, int yr)
         : vehicleID(id), manufacturer(manu), model(mod), year(yr), active(true) {
-        totalVehicles++;
+        countChange(1);
     }
-    virtual ~Vehicle() { if (active) totalVehicles--; }
+    virtual ~Vehicle() { if (active) countChange(-1); }
 
     // setters/getters (encapsulation)
     void setVehicleID(int id) { ensureActive(); vehicleID = id; }
     int getVehicleID() const { return vehicleID; }
 
-    void setManufacturer(const string& m) { ensureActive(); manufacturer = m; }
-    string getManufacturer() const { return manufacturer; }
+    // views stay valid until the field is set again or the vehicle is destroyed
+    void setManufacturer(string_view m) { ensureActive(); manufacturer = m; }
+    string_view getManufacturer() const { return manufacturer; }
 
-    void setModel(const string& m) { ensureActive(); model = m; }
-    string getModel() const { return model; }
+    void setModel(string_view m) { ensureActive(); model = m; }
+    string_view getModel() const { return model; }
 
     void setYear(int y) { ensureActive(); year = y; }
     int getYear() const { return year; }
 
-    static int getTotalVehicles() { return totalVehicles; }
+    // exact for the calling thread's own changes; other threads that are still
+    // running may each hold back up to COUNT_BATCH - 1
+    static long getTotalVehicles() { return publishedVehicles.load(memory_order_relaxed) + pendingVehicles.delta; }
+
+    virtual const char* typeName() const { return "Vehicle"; }
 
-    virtual void displayDetails() const {
-        cout << "ID: " << vehicleID
-             << ", Manufacturer: " << manufacturer
-             << ", Model: " << model
-             << ", Year: " << year;
+    // emits the fields in display order; subclasses append their own
+    virtual void writeFields(RecordWriter& w) const {
+        w.field("id", "ID", vehicleID);
+        w.field("manufacturer", "Manufacturer", manufacturer);
+        w.field("model", "Model", model);
+        w.field("year", "Year", year);
+    }
+
+    void displayDetails() const {
+        OutputBuffer out(cout, 256);
+        RecordWriter w(out, OutputFormat::Table);
+        w.begin();
+        writeFields(w);
     }
 };
 
-int Vehicle::totalVehicles = 0;
+atomic<long> Vehicle::publishedVehicles(0);
+thread_local Vehicle::PendingCount Vehicle::pendingVehicles;
 
 /* Single inheritance */
 class Car : public Vehicle {
 private:
-    string fuelType;
+    InlineString<15> fuelType;
 public:
-    Car(int id = 0, const string& manu = "", const string& mod = "", int yr = 0, const string& fuel = "")
+    Car(int id = 0, string_view manu = "", string_view mod = "", int yr = 0, string_view fuel = "")
         : Vehicle(id, manu, mod, yr), fuelType(fuel) {}
     virtual ~Car() {}
 
-    void setFuelType(const string& f) { fuelType = f; }
-    string getFuelType() const { return fuelType; }
+    void setFuelType(string_view f) { fuelType = f; }
+    string_view getFuelType() const { return fuelType; }
+
+    const char* typeName() const override { return "Car"; }
 
-    void displayDetails() const override {
-        Vehicle::displayDetails();
-        cout << ", Fuel: " << fuelType;
+    void writeFields(RecordWriter& w) const override {
+        Vehicle::writeFields(w);
+        w.field("fuel", "Fuel", fuelType);
     }
 };
 
@@ -71,17 +145,19 @@ class ElectricCar : public Car {
 private:
     int batteryCapacity; // kWh
 public:
-    ElectricCar(int id = 0, const string& manu = "", const string& mod = "", int yr = 0,
-                const string& fuel = "", int batt = 0)
+    ElectricCar(int id = 0, string_view manu = "", string_view mod = "", int yr = 0,
+                string_view fuel = "", int batt = 0)
         : Car(id, manu, mod, yr, fuel), batteryCapacity(batt) {}
     virtual ~ElectricCar() {}
 
     void setBatteryCapacity(int b) { batteryCapacity = b; }
     int getBatteryCapacity() const { return batteryCapacity; }
 
-    void displayDetails() const override {
-        Car::displayDetails();
-        cout << ", Battery: " << batteryCapacity << " kWh";
+    const char* typeName() const override { return "ElectricCar"; }
+
+    void writeFields(RecordWriter& w) const override {
+        Car::writeFields(w);
+        w.field("battery", "Battery", batteryCapacity, " kWh");
     }
 };
 
@@ -96,22 +172,24 @@ public:
     void setFlightRange(int r) { flightRange = r; }
     int getFlightRange() const { return flightRange; }
 
-    virtual void displayAircraftDetails() const {
-        cout << ", Range: " << flightRange << " km";
+    virtual void writeAircraftFields(RecordWriter& w) const {
+        w.field("range", "Range", flightRange, " km");
     }
 };
 
 /* Multiple inheritance */
 class FlyingCar : public Car, public Aircraft {
 public:
-    FlyingCar(int id = 0, const string& manu = "", const string& mod = "", int yr = 0,
-              const string& fuel = "", int range = 0)
+    FlyingCar(int id = 0, string_view manu = "", string_view mod = "", int yr = 0,
+              string_view fuel = "", int range = 0)
         : Car(id, manu, mod, yr, fuel), Aircraft(range) {}
     virtual ~FlyingCar() {}
 
-    void displayDetails() const override {
-        Car::displayDetails();
-        Aircraft::displayAircraftDetails();
+    const char* typeName() const override { return "FlyingCar"; }
+
+    void writeFields(RecordWriter& w) const override {
+        Car::writeFields(w);
+        Aircraft::writeAircraftFields(w);
     }
 };
 
@@ -120,64 +198,1071 @@ class SportsCar : public ElectricCar {
 private:
     int topSpeed; // km/h
 public:
-    SportsCar(int id = 0, const string& manu = "", const string& mod = "", int yr = 0,
-              const string& fuel = "", int batt = 0, int speed = 0)
+    SportsCar(int id = 0, string_view manu = "", string_view mod = "", int yr = 0,
+              string_view fuel = "", int batt = 0, int speed = 0)
         : ElectricCar(id, manu, mod, yr, fuel, batt), topSpeed(speed) {}
     virtual ~SportsCar() {}
 
     void setTopSpeed(int s) { topSpeed = s; }
     int getTopSpeed() const { return topSpeed; }
 
-    void displayDetails() const override {
-        ElectricCar::displayDetails();
-        cout << ", Top Speed: " << topSpeed << " km/h";
+    const char* typeName() const override { return "SportsCar"; }
+
+    void writeFields(RecordWriter& w) const override {
+        ElectricCar::writeFields(w);
+        w.field("speed", "Top Speed", topSpeed, " km/h");
     }
 };
 
 /* Hierarchical inheritance */
 class Sedan : public Car {
 public:
-    Sedan(int id = 0, const string& manu = "", const string& mod = "", int yr = 0, const string& fuel = "")
+    Sedan(int id = 0, string_view manu = "", string_view mod = "", int yr = 0, string_view fuel = "")
         : Car(id, manu, mod, yr, fuel) {}
     virtual ~Sedan() {}
-    void displayDetails() const override {
-        cout << "[Sedan] ";
-        Car::displayDetails();
+    const char* typeName() const override { return "Sedan"; }
+
+    void writeFields(RecordWriter& w) const override {
+        w.text("[Sedan] ");
+        Car::writeFields(w);
     }
 };
 
 class SUV : public Car {
 public:
-    SUV(int id = 0, const string& manu = "", const string& mod = "", int yr = 0, const string& fuel = "")
+    SUV(int id = 0, string_view manu = "", string_view mod = "", int yr = 0, string_view fuel = "")
         : Car(id, manu, mod, yr, fuel) {}
     virtual ~SUV() {}
-    void displayDetails() const override {
-        cout << "[SUV] ";
-        Car::displayDetails();
+    const char* typeName() const override { return "SUV"; }
+
+    void writeFields(RecordWriter& w) const override {
+        w.text("[SUV] ");
+        Car::writeFields(w);
+    }
+};
+
+/* VehicleIdIndex: open-addressing (linear probing) hash index from vehicleID
+   to a slot in the registry's store. Capacity is a power of two and the load
+   factor is kept at or below 1/2, so lookups take a couple of probes. */
+class VehicleIdIndex {
+private:
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Entry {
+        int key;
+        uint32_t slot; // EMPTY when unused
+    };
+
+    vector<Entry> table;
+    size_t used;
+    int shift; // 64 - log2(capacity)
+
+    size_t home(int id) const {
+        // Fibonacci hashing: spreads sequential IDs across the table
+        return (size_t)(((uint64_t)(uint32_t)id * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    void rehash(size_t capacity) {
+        vector<Entry> old;
+        old.swap(table);
+        table.assign(capacity, Entry{0, EMPTY});
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) shift--;
+        used = 0;
+        for (const Entry& e : old)
+            if (e.slot != EMPTY) insert(e.key, e.slot);
+    }
+
+public:
+    VehicleIdIndex() : used(0), shift(64) { rehash(16); }
+
+    void reserve(size_t n) {
+        size_t capacity = table.size();
+        while (capacity < n * 2) capacity *= 2;
+        if (capacity != table.size()) rehash(capacity);
+    }
+
+    // returns false (and leaves the index unchanged) if id is already present
+    bool insert(int id, uint32_t slot) {
+        if ((used + 1) * 2 > table.size()) rehash(table.size() * 2);
+        size_t mask = table.size() - 1;
+        for (size_t i = home(id); ; i = (i + 1) & mask) {
+            if (table[i].slot == EMPTY) {
+                table[i].key = id;
+                table[i].slot = slot;
+                used++;
+                return true;
+            }
+            if (table[i].key == id) return false;
+        }
+    }
+
+    // starts loading the cache line an insert or find of id will probe first
+    void prefetch(int id) const { __builtin_prefetch(&table[home(id)]); }
+
+    // slot of id, or -1 if not present
+    long find(int id) const {
+        size_t mask = table.size() - 1;
+        for (size_t i = home(id); ; i = (i + 1) & mask) {
+            if (table[i].slot == EMPTY) return -1;
+            if (table[i].key == id) return (long)table[i].slot;
+        }
+    }
+
+    size_t size() const { return used; }
+};
+
+/* SlabPool: per-type arena. Objects are constructed in place inside large slabs
+   and only destroyed together, so a bulk load costs one allocation per slab and
+   teardown frees slabs instead of individual objects. */
+template <class T>
+class SlabPool {
+private:
+    static const size_t SLAB_OBJECTS = 4096;
+
+    vector<T*> slabs;
+    size_t count; // objects constructed so far
+
+public:
+    SlabPool() : count(0) {}
+    ~SlabPool() { clear(); }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    template <class... Args>
+    T* create(Args&&... args) {
+        size_t offset = count % SLAB_OBJECTS;
+        if (offset == 0 && count / SLAB_OBJECTS == slabs.size())
+            slabs.push_back(static_cast<T*>(::operator new(sizeof(T) * SLAB_OBJECTS)));
+        T* obj = new (slabs[count / SLAB_OBJECTS] + offset) T(std::forward<Args>(args)...);
+        count++;
+        return obj;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < count; ++i) slabs[i / SLAB_OBJECTS][i % SLAB_OBJECTS].~T();
+        for (T* slab : slabs) ::operator delete(slab);
+        slabs.clear();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t slabCount() const { return slabs.size(); }
+};
+
+/* Type tag for the concrete classes of the Vehicle hierarchy */
+enum class VehicleType : uint8_t { Car, ElectricCar, SportsCar, FlyingCar, Sedan, SUV };
+
+inline uint32_t typeBit(VehicleType t) { return 1u << (unsigned)t; }
+
+/* FleetQuery: conjunction of predicates over FleetColumns. Every range is
+   inclusive; fields a type does not have (battery on a Sedan, ...) read as 0. */
+struct FleetQuery {
+    uint32_t typeMask = 0x3F; // all six types
+    int minYear = INT_MIN, maxYear = INT_MAX;
+    int minBattery = INT_MIN, maxBattery = INT_MAX;
+    int minTopSpeed = INT_MIN, maxTopSpeed = INT_MAX;
+    int minFlightRange = INT_MIN, maxFlightRange = INT_MAX;
+
+    FleetQuery& types(uint32_t mask) { typeMask = mask; return *this; }
+    FleetQuery& year(int lo, int hi = INT_MAX) { minYear = lo; maxYear = hi; return *this; }
+    FleetQuery& battery(int lo, int hi = INT_MAX) { minBattery = lo; maxBattery = hi; return *this; }
+    FleetQuery& topSpeed(int lo, int hi = INT_MAX) { minTopSpeed = lo; maxTopSpeed = hi; return *this; }
+    FleetQuery& flightRange(int lo, int hi = INT_MAX) { minFlightRange = lo; maxFlightRange = hi; return *this; }
+};
+
+/* FleetAggregation: rows matching a FleetQuery, split into groups, with one
+   numeric column summarized per group, e.g.
+     FleetAggregation().by(FleetGroupBy::Manufacturer)                  vehicles per manufacturer
+     FleetAggregation().where(FleetQuery().types(typeBit(VehicleType::ElectricCar)))
+                       .measure(FleetMeasure::Battery)                  mean() = average battery */
+enum class FleetGroupBy : uint8_t { None, Type, Manufacturer, Year };
+enum class FleetMeasure : uint8_t { Year, Battery, TopSpeed, FlightRange };
+
+struct FleetAggregation {
+    FleetQuery filter;
+    FleetGroupBy groupBy = FleetGroupBy::None;
+    FleetMeasure column = FleetMeasure::Year;
+
+    FleetAggregation& where(const FleetQuery& q) { filter = q; return *this; }
+    FleetAggregation& by(FleetGroupBy g) { groupBy = g; return *this; }
+    FleetAggregation& measure(FleetMeasure m) { column = m; return *this; }
+};
+
+// count, sum, min and max of the measured column over one group's rows
+struct GroupStats {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t min = INT32_MAX, max = INT32_MIN;
+
+    void add(int32_t v) {
+        count++;
+        sum += v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+
+    void merge(const GroupStats& o) {
+        count += o.count;
+        sum += o.sum;
+        if (o.min < min) min = o.min;
+        if (o.max > max) max = o.max;
+    }
+
+    double mean() const { return count ? (double)sum / count : 0; }
+};
+
+// key: 0 ungrouped, the VehicleType, the manufacturer code (see
+// FleetColumns::manufacturerName) or the year
+struct FleetGroup {
+    int key;
+    GroupStats stats;
+};
+
+/* WorkStealingRanges: hands out the work items [0, n) to a fixed set of
+   workers. Each worker starts with an equal contiguous share and takes items
+   from its front; a worker whose share is used up steals the back half of
+   the largest share left, so a worker that was slowed down (by a heavier part
+   of the data or by losing its core) is relieved by the others. A share is
+   one atomic word (next | end << 32), so taking and stealing are single
+   compare-and-swaps and no lock is involved. */
+class WorkStealingRanges {
+private:
+    struct alignas(64) Share {
+        atomic<uint64_t> range;
+    };
+
+    unique_ptr<Share[]> shares;
+    unsigned workers;
+    atomic<size_t> steals;
+
+    static uint64_t pack(uint32_t next, uint32_t end) { return next | (uint64_t)end << 32; }
+    static uint32_t left(uint64_t r) {
+        uint32_t next = (uint32_t)r, end = (uint32_t)(r >> 32);
+        return next < end ? end - next : 0;
+    }
+
+    bool takeFront(unsigned w, uint32_t& item) {
+        atomic<uint64_t>& r = shares[w].range;
+        uint64_t cur = r.load(memory_order_acquire);
+        while (left(cur)) {
+            if (r.compare_exchange_weak(cur, pack((uint32_t)cur + 1, (uint32_t)(cur >> 32)), memory_order_acq_rel)) {
+                item = (uint32_t)cur;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // moves the back half of the largest other share into w's (which is
+    // empty, so no other worker touches it); false once every share is empty
+    bool steal(unsigned w) {
+        for (;;) {
+            unsigned victim = w;
+            uint32_t most = 0;
+            uint64_t seen = 0;
+            for (unsigned i = 0; i < workers; ++i) {
+                uint64_t r = shares[i].range.load(memory_order_acquire);
+                if (left(r) > most) {
+                    most = left(r);
+                    victim = i;
+                    seen = r;
+                }
+            }
+            if (most == 0) return false;
+            uint32_t end = (uint32_t)(seen >> 32), mid = end - (most + 1) / 2;
+            if (!shares[victim].range.compare_exchange_strong(seen, pack((uint32_t)seen, mid), memory_order_acq_rel))
+                continue; // the owner or another thief got there first
+            shares[w].range.store(pack(mid, end), memory_order_release);
+            steals.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+public:
+    WorkStealingRanges(uint32_t items, unsigned workerCount)
+        : shares(new Share[workerCount]), workers(workerCount), steals(0) {
+        for (unsigned w = 0; w < workers; ++w)
+            shares[w].range.store(pack((uint32_t)((uint64_t)items * w / workers),
+                                       (uint32_t)((uint64_t)items * (w + 1) / workers)), memory_order_relaxed);
+    }
+
+    // the next item for worker w; false when all items have been handed out
+    bool next(unsigned w, uint32_t& item) {
+        while (!takeFront(w, item))
+            if (!steal(w)) return false;
+        return true;
+    }
+
+    size_t stealCount() const { return steals.load(memory_order_relaxed); }
+};
+
+/* FleetColumns: struct-of-arrays copy of the fleet for filter scans. Row i
+   describes the i-th registered vehicle. Scans run block by block with
+   branch-free predicates over dense columns so the compiler can vectorize
+   them, and never touch the Vehicle objects. */
+class FleetColumns {
+private:
+    static constexpr size_t BLOCK = 1024;
+    static constexpr size_t MORSEL = 16 * BLOCK; // rows per scheduled unit of a parallel aggregate
+    static const int MAX_YEAR_GROUPS = 1 << 16;  // widest year span grouped by direct indexing
+
+    vector<uint8_t> type;
+    vector<int32_t> year;
+    vector<int32_t> batteryCapacity;
+    vector<int32_t> topSpeed;
+    vector<int32_t> flightRange;
+    vector<uint32_t> manufacturer; // code into manufacturerNames
+
+    deque<string> manufacturerNames; // by code, as first registered; elements never move
+    unordered_map<string_view, uint32_t> manufacturerCodes;
+    int minYearSeen = INT_MAX, maxYearSeen = INT_MIN;
+
+    void push(VehicleType t, const Vehicle& v, int batt, int speed, int range) {
+        string_view name = v.getManufacturer();
+        auto known = manufacturerCodes.find(name);
+        if (known == manufacturerCodes.end()) {
+            manufacturerNames.emplace_back(name);
+            known = manufacturerCodes.emplace(manufacturerNames.back(), (uint32_t)manufacturerNames.size() - 1).first;
+        }
+        int yr = v.getYear();
+        minYearSeen = min(minYearSeen, yr);
+        maxYearSeen = max(maxYearSeen, yr);
+        type.push_back((uint8_t)t);
+        year.push_back(yr);
+        batteryCapacity.push_back(batt);
+        topSpeed.push_back(speed);
+        flightRange.push_back(range);
+        manufacturer.push_back(known->second);
+    }
+
+    // lo <= x <= hi as a single unsigned compare
+    static uint8_t inRange(int32_t x, int32_t lo, int32_t hi) {
+        return (uint32_t)x - (uint32_t)lo <= (uint32_t)hi - (uint32_t)lo;
+    }
+
+    // match[i] = 1 if row begin+i satisfies q
+    void matchBlock(const FleetQuery& q, size_t begin, size_t n, uint8_t* match) const {
+        const uint8_t* t = type.data() + begin;
+        const int32_t* yr = year.data() + begin;
+        const int32_t* bt = batteryCapacity.data() + begin;
+        const int32_t* sp = topSpeed.data() + begin;
+        const int32_t* rg = flightRange.data() + begin;
+        for (size_t i = 0; i < n; ++i)
+            match[i] = (uint8_t)((q.typeMask >> t[i]) & 1u)
+                     & inRange(yr[i], q.minYear, q.maxYear)
+                     & inRange(bt[i], q.minBattery, q.maxBattery)
+                     & inRange(sp[i], q.minTopSpeed, q.maxTopSpeed)
+                     & inRange(rg[i], q.minFlightRange, q.maxFlightRange);
+    }
+
+    const int32_t* measured(FleetMeasure m) const {
+        switch (m) {
+            case FleetMeasure::Battery: return batteryCapacity.data();
+            case FleetMeasure::TopSpeed: return topSpeed.data();
+            case FleetMeasure::FlightRange: return flightRange.data();
+            default: return year.data();
+        }
+    }
+
+    // offsets of the matching rows of block [begin, begin + n) into rows;
+    // returns how many. Written without a branch on the match, which would be
+    // mispredicted about as often as rows match.
+    size_t matchingRows(const FleetQuery& q, size_t begin, size_t n, uint16_t* rows) const {
+        uint8_t match[BLOCK];
+        matchBlock(q, begin, n, match);
+        size_t k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            rows[k] = (uint16_t)i;
+            k += match[i];
+        }
+        return k;
+    }
+
+    // folds the matching rows of [begin, end) into groups.at(groupOf(row))
+    template <class GroupOf, class Groups>
+    void foldRows(const FleetAggregation& a, size_t begin, size_t end, GroupOf groupOf, Groups& groups) const {
+        uint16_t rows[BLOCK];
+        const int32_t* m = measured(a.column);
+        for (size_t b = begin; b < end; b += BLOCK) {
+            size_t k = matchingRows(a.filter, b, min(BLOCK, end - b), rows);
+            for (size_t i = 0; i < k; ++i) groups.at(groupOf(b + rows[i])).add(m[b + rows[i]]);
+        }
+    }
+
+    // ungrouped: the same fold with the totals kept in registers
+    void foldRows(const FleetAggregation& a, size_t begin, size_t end, GroupStats& g) const {
+        uint16_t rows[BLOCK];
+        const int32_t* m = measured(a.column);
+        int64_t sum = 0;
+        int32_t lo = g.min, hi = g.max;
+        for (size_t b = begin; b < end; b += BLOCK) {
+            size_t k = matchingRows(a.filter, b, min(BLOCK, end - b), rows);
+            for (size_t i = 0; i < k; ++i) {
+                int32_t v = m[b + rows[i]];
+                sum += v;
+                lo = min(lo, v);
+                hi = max(hi, v);
+            }
+            g.count += k;
+        }
+        g.sum += sum;
+        g.min = lo;
+        g.max = hi;
+    }
+
+    // one worker's groups: indexed directly (types, manufacturer codes, a
+    // normal span of years) or, for a very wide span of years, hashed
+    struct Partial {
+        vector<GroupStats> dense;
+        unordered_map<int, GroupStats> sparse;
+        GroupStats& at(uint32_t i) { return dense[i]; }
+    };
+    struct SparseYears {
+        Partial& p;
+        GroupStats& at(int yr) { return p.sparse[yr]; }
+    };
+
+    void aggregateMorsel(const FleetAggregation& a, uint32_t morsel, Partial& p) const {
+        size_t begin = (size_t)morsel * MORSEL, end = min(size(), begin + MORSEL);
+        const uint8_t* t = type.data();
+        const int32_t* yr = year.data();
+        const uint32_t* manu = manufacturer.data();
+        int base = minYearSeen;
+        switch (a.groupBy) {
+            case FleetGroupBy::None: foldRows(a, begin, end, p.dense[0]); break;
+            case FleetGroupBy::Type: foldRows(a, begin, end, [t](size_t r) { return (uint32_t)t[r]; }, p); break;
+            case FleetGroupBy::Manufacturer: foldRows(a, begin, end, [manu](size_t r) { return manu[r]; }, p); break;
+            case FleetGroupBy::Year:
+                if (p.dense.empty()) {
+                    SparseYears s{p};
+                    foldRows(a, begin, end, [yr](size_t r) { return yr[r]; }, s);
+                } else {
+                    foldRows(a, begin, end, [yr, base](size_t r) { return (uint32_t)(yr[r] - base); }, p);
+                }
+                break;
+        }
+    }
+
+    // groups a worker needs to index directly; 0 means it hashes them
+    size_t denseGroups(FleetGroupBy g) const {
+        switch (g) {
+            case FleetGroupBy::None: return 1;
+            case FleetGroupBy::Type: return 6;
+            case FleetGroupBy::Manufacturer: return manufacturerNames.size();
+            case FleetGroupBy::Year:
+                if (size() == 0) return 1;
+                return (int64_t)maxYearSeen - minYearSeen < MAX_YEAR_GROUPS ? (size_t)(maxYearSeen - minYearSeen + 1) : 0;
+        }
+        return 1;
+    }
+
+public:
+    void reserve(size_t n) {
+        type.reserve(n); year.reserve(n); batteryCapacity.reserve(n);
+        topSpeed.reserve(n); flightRange.reserve(n); manufacturer.reserve(n);
+    }
+
+    // one overload per concrete class, picked from the static type at insert time
+    void append(const Car& v) { push(VehicleType::Car, v, 0, 0, 0); }
+    void append(const ElectricCar& v) { push(VehicleType::ElectricCar, v, v.getBatteryCapacity(), 0, 0); }
+    void append(const SportsCar& v) {
+        push(VehicleType::SportsCar, v, v.getBatteryCapacity(), v.getTopSpeed(), 0);
+    }
+    void append(const FlyingCar& v) { push(VehicleType::FlyingCar, v, 0, 0, v.getFlightRange()); }
+    void append(const Sedan& v) { push(VehicleType::Sedan, v, 0, 0, 0); }
+    void append(const SUV& v) { push(VehicleType::SUV, v, 0, 0, 0); }
+
+    // for vehicles whose static type is only Vehicle*
+    void appendDynamic(const Vehicle* v) {
+        if (auto sports = dynamic_cast<const SportsCar*>(v)) append(*sports);
+        else if (auto ev = dynamic_cast<const ElectricCar*>(v)) append(*ev);
+        else if (auto flying = dynamic_cast<const FlyingCar*>(v)) append(*flying);
+        else if (auto sedan = dynamic_cast<const Sedan*>(v)) append(*sedan);
+        else if (auto suv = dynamic_cast<const SUV*>(v)) append(*suv);
+        else if (auto car = dynamic_cast<const Car*>(v)) append(*car);
+        else push(VehicleType::Car, *v, 0, 0, 0);
+    }
+
+    size_t size() const { return type.size(); }
+    VehicleType typeAt(size_t row) const { return (VehicleType)type[row]; }
+    string_view manufacturerName(uint32_t code) const { return manufacturerNames[code]; }
+
+    size_t count(const FleetQuery& q) const {
+        uint8_t match[BLOCK];
+        size_t total = 0;
+        for (size_t begin = 0; begin < size(); begin += BLOCK) {
+            size_t n = min(BLOCK, size() - begin);
+            matchBlock(q, begin, n, match);
+            for (size_t i = 0; i < n; ++i) total += match[i];
+        }
+        return total;
+    }
+
+    // row numbers of all matching vehicles, in registration order
+    vector<uint32_t> select(const FleetQuery& q) const {
+        uint8_t match[BLOCK];
+        vector<uint32_t> rows;
+        for (size_t begin = 0; begin < size(); begin += BLOCK) {
+            size_t n = min(BLOCK, size() - begin);
+            matchBlock(q, begin, n, match);
+            for (size_t i = 0; i < n; ++i) {
+                if (match[i]) rows.push_back((uint32_t)(begin + i));
+            }
+        }
+        return rows;
+    }
+
+    // evaluates a on `threads` workers (0: one per core) and returns the
+    // non-empty groups by ascending key. The rows are cut into morsels handed
+    // out by WorkStealingRanges; each worker folds its morsels into groups of
+    // its own, and those are merged once every worker is done. stolen, if
+    // given, receives how often a worker took over part of another's share.
+    vector<FleetGroup> aggregate(const FleetAggregation& a, unsigned threads = 0, size_t* stolen = nullptr) const {
+        uint32_t morsels = (uint32_t)((size() + MORSEL - 1) / MORSEL);
+        if (threads == 0) threads = thread::hardware_concurrency();
+        threads = max(1u, min(threads, morsels));
+        size_t groups = denseGroups(a.groupBy);
+        vector<Partial> partials(threads);
+        WorkStealingRanges work(morsels, threads);
+        auto run = [&](unsigned w) {
+            Partial p; // allocated by its own thread, away from the other workers' groups
+            p.dense.resize(groups);
+            uint32_t m;
+            while (work.next(w, m)) aggregateMorsel(a, m, p);
+            partials[w] = std::move(p);
+        };
+        vector<thread> pool;
+        for (unsigned w = 1; w < threads; ++w) pool.emplace_back(run, w);
+        run(0);
+        for (thread& t : pool) t.join();
+        if (stolen) *stolen = work.stealCount();
+
+        Partial& total = partials[0];
+        for (unsigned w = 1; w < threads; ++w) {
+            for (size_t i = 0; i < groups; ++i) total.dense[i].merge(partials[w].dense[i]);
+            for (auto& g : partials[w].sparse) total.sparse[g.first].merge(g.second);
+        }
+        vector<FleetGroup> out;
+        int base = a.groupBy == FleetGroupBy::Year ? minYearSeen : 0;
+        for (size_t i = 0; i < groups; ++i)
+            if (total.dense[i].count) out.push_back(FleetGroup{base + (int)i, total.dense[i]});
+        for (auto& g : total.sparse) out.push_back(FleetGroup{g.first, g.second});
+        if (!total.sparse.empty())
+            sort(out.begin(), out.end(), [](const FleetGroup& x, const FleetGroup& y) { return x.key < y.key; });
+        return out;
+    }
+};
+
+/* FleetAttributeIndex: secondary indexes on manufacturer, model and year,
+   updated as vehicles are registered. Entries are row numbers in registration
+   order. Names are keyed case-folded in ordered maps, so a prefix is a range of
+   keys; every manufacturer also keeps its own model map, and under every name
+   the rows are split by year, so a year range is a range of buckets. A query
+   visits only the buckets it returns rows from (plus one lookup per matching
+   name), never the whole fleet. Inserts find their buckets through hash maps
+   on the exact spelling, which avoid the ordered-map walks and case folding. */
+class FleetAttributeIndex {
+private:
+    // rows of one name split by year; a name spans few years, so the years
+    // are a small sorted array
+    struct YearBuckets {
+        vector<int> years;
+        vector<vector<uint32_t>> rows;
+
+        vector<uint32_t>& at(int year) {
+            size_t i = lower_bound(years.begin(), years.end(), year) - years.begin();
+            if (i == years.size() || years[i] != year) {
+                years.insert(years.begin() + i, year);
+                rows.insert(rows.begin() + i, vector<uint32_t>());
+            }
+            return rows[i];
+        }
+
+        template <class F>
+        size_t forRange(int lo, int hi, F& f) const {
+            size_t n = 0;
+            for (size_t i = lower_bound(years.begin(), years.end(), lo) - years.begin();
+                 i < years.size() && years[i] <= hi; ++i) {
+                for (uint32_t row : rows[i]) f(row);
+                n += rows[i].size();
+            }
+            return n;
+        }
+    };
+
+    struct ModelBuckets {
+        YearBuckets* inManufacturer;
+        YearBuckets* overall;
+    };
+
+    struct Manufacturer {
+        YearBuckets years;
+        map<string, YearBuckets> models;
+        unordered_map<string_view, ModelBuckets> modelsBySpelling;
+    };
+
+    map<string, Manufacturer> byManufacturer;
+    map<string, YearBuckets> byModel;
+    YearBuckets byYear;
+    unordered_map<string_view, Manufacturer*> manufacturersBySpelling; // map nodes never move
+    deque<string> spellings; // the keys of the *BySpelling maps; deque elements never move
+
+    string_view keep(string_view s) {
+        spellings.emplace_back(s);
+        return spellings.back();
+    }
+
+    static string folded(string_view s) {
+        string out(s);
+        for (char& c : out) c = (char)tolower((unsigned char)c);
+        return out;
+    }
+
+    // calls f(entry) for every key of m that starts with prefix
+    template <class M, class F>
+    static void forPrefix(const M& m, const string& prefix, F f) {
+        for (auto it = m.lower_bound(prefix); it != m.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            f(it->second);
+    }
+
+public:
+    // allocates only for a spelling it has not seen before (and when a bucket grows)
+    void add(uint32_t row, string_view manufacturer, string_view model, int year) {
+        Manufacturer* m;
+        auto knownMake = manufacturersBySpelling.find(manufacturer);
+        if (knownMake != manufacturersBySpelling.end()) m = knownMake->second;
+        else {
+            m = &byManufacturer[folded(manufacturer)];
+            manufacturersBySpelling.emplace(keep(manufacturer), m);
+        }
+        ModelBuckets mb;
+        auto knownModel = m->modelsBySpelling.find(model);
+        if (knownModel != m->modelsBySpelling.end()) mb = knownModel->second;
+        else {
+            string mod = folded(model);
+            mb = ModelBuckets{&m->models[mod], &byModel[mod]};
+            m->modelsBySpelling.emplace(keep(model), mb);
+        }
+        m->years.at(year).push_back(row);
+        mb.inManufacturer->at(year).push_back(row);
+        mb.overall->at(year).push_back(row);
+        byYear.at(year).push_back(row);
+    }
+
+    // f(row) for every row whose manufacturer and model start with the given
+    // prefixes (any case; empty matches everything) and whose year is in
+    // [minYear, maxYear]. Rows come grouped by name, then by ascending year,
+    // then in registration order. Returns the number of rows visited.
+    template <class F>
+    size_t query(string_view manufacturer, string_view model, int minYear, int maxYear, F f) const {
+        if (minYear > maxYear) return 0;
+        string make = folded(manufacturer), mod = folded(model);
+        size_t n = 0;
+        if (make.empty() && mod.empty()) return byYear.forRange(minYear, maxYear, f);
+        if (make.empty()) {
+            forPrefix(byModel, mod, [&](const YearBuckets& y) { n += y.forRange(minYear, maxYear, f); });
+            return n;
+        }
+        forPrefix(byManufacturer, make, [&](const Manufacturer& m) {
+            if (mod.empty()) n += m.years.forRange(minYear, maxYear, f);
+            else forPrefix(m.models, mod, [&](const YearBuckets& y) { n += y.forRange(minYear, maxYear, f); });
+        });
+        return n;
+    }
+};
+
+/* One row of a fleet import file:
+   type, id, manufacturer, model, year, fuel, battery, speed, range
+   The string fields point into the mapped file; nothing is copied. */
+struct FleetRecord {
+    VehicleType type;
+    int id, year, battery, speed, range;
+    string_view manufacturer, model, fuel;
+};
+
+// accepts the class name (any case) or the menu number 1-6
+bool parseVehicleType(string_view s, VehicleType& out) {
+    static const string_view names[] = {"car", "electriccar", "sportscar", "flyingcar", "sedan", "suv"};
+    static const VehicleType byMenu[] = {VehicleType::Car, VehicleType::ElectricCar, VehicleType::SportsCar,
+                                         VehicleType::FlyingCar, VehicleType::Sedan, VehicleType::SUV};
+    if (s.size() == 1 && s[0] >= '1' && s[0] <= '6') { out = byMenu[s[0] - '1']; return true; }
+    for (int t = 0; t < 6; ++t) {
+        if (s.size() != names[t].size() || (s[0] | 0x20) != names[t][0]) continue;
+        size_t i = 1;
+        while (i < s.size() && (s[i] | 0x20) == names[t][i]) i++;
+        if (i == s.size()) { out = (VehicleType)t; return true; }
+    }
+    return false;
+}
+
+/* MappedFile: read-only mmap of a whole file */
+class MappedFile {
+private:
+    const char* base;
+    size_t length;
+
+public:
+    MappedFile() : base(nullptr), length(0) {}
+    ~MappedFile() { if (base) munmap((void*)base, length); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE; // prefault the page cache mapping in one call
+#endif
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+            if (p == MAP_FAILED) ok = false;
+            else {
+                base = (const char*)p;
+                length = (size_t)st.st_size;
+                madvise(p, length, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+/* FleetCsvReader: zero-copy tokenizer over a CSV or TSV buffer. The delimiter
+   is taken from the first line (tab if it has one, else comma), and a header
+   line starting with "type" is skipped. Fields are not quoted; use TSV when a
+   name contains commas. Trailing numeric fields may be empty or missing. */
+class FleetCsvReader {
+private:
+    const char* cur;
+    const char* end;
+    char delim;
+    size_t line;
+    const char* block; // 64-byte window whose separators are in sepMask
+    uint64_t sepMask;  // bit i set: block[i] is a delimiter or '\n' not yet consumed
+
+    static bool toInt(string_view f, int& out) {
+        if (f.empty()) { out = 0; return true; }
+        auto r = from_chars(f.data(), f.data() + f.size(), out);
+        return r.ec == errc() && r.ptr == f.data() + f.size();
+    }
+
+    // bitmask of delimiter and '\n' bytes in the 64 bytes at b (fewer near the end)
+    uint64_t separatorsIn(const char* b) const {
+        uint64_t m = 0;
+        if (end - b >= 64) {
+#if defined(__SSE2__)
+            const __m128i d = _mm_set1_epi8(delim), nl = _mm_set1_epi8('\n');
+            for (int i = 0; i < 4; ++i) {
+                __m128i c = _mm_loadu_si128((const __m128i*)(b + 16 * i));
+                m |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, d), _mm_cmpeq_epi8(c, nl)))
+                     << (16 * i);
+            }
+            return m;
+#elif defined(__ARM_NEON)
+            const uint8x16_t d = vdupq_n_u8((uint8_t)delim), nl = vdupq_n_u8('\n');
+            const uint8x16_t bit = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+            uint8x16_t t[4];
+            for (int i = 0; i < 4; ++i) {
+                uint8x16_t c = vld1q_u8((const uint8_t*)b + 16 * i);
+                t[i] = vandq_u8(vorrq_u8(vceqq_u8(c, d), vceqq_u8(c, nl)), bit);
+            }
+            // pairwise adds fold the per-byte bits into one 64-bit movemask
+            uint8x16_t sum = vpaddq_u8(vpaddq_u8(t[0], t[1]), vpaddq_u8(t[2], t[3]));
+            sum = vpaddq_u8(sum, sum);
+            return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+#endif
+        }
+        size_t n = min<ptrdiff_t>(64, end - b);
+        for (size_t i = 0; i < n; ++i)
+            m |= (uint64_t)(b[i] == delim || b[i] == '\n') << i;
+        return m;
+    }
+
+    // next unconsumed separator, or end
+    const char* nextSeparator() {
+        while (sepMask == 0) {
+            block += 64;
+            if (block >= end) { block = end; return end; }
+            sepMask = separatorsIn(block);
+        }
+        const char* p = block + __builtin_ctzll(sepMask);
+        sepMask &= sepMask - 1;
+        return p;
+    }
+
+    void startAt(const char* p) {
+        cur = block = p;
+        sepMask = p < end ? separatorsIn(p) : 0;
+    }
+
+public:
+    enum Result { ROW, BAD_ROW, END };
+
+    FleetCsvReader(const char* data, size_t size)
+        : cur(data), end(data + size), delim(','), line(0), block(data), sepMask(0) {
+        const char* nl = size ? (const char*)memchr(data, '\n', size) : nullptr;
+        const char* first = nl ? nl : end;
+        if (size && memchr(data, '\t', first - data)) delim = '\t';
+        if (first - data >= 4 && strncasecmp(data, "type", 4) == 0) {
+            startAt(nl ? nl + 1 : end);
+            line = 1;
+        } else {
+            startAt(data);
+        }
+    }
+
+    // line number (1-based) of the row last returned
+    size_t lineNumber() const { return line; }
+
+    Result next(FleetRecord& rec) {
+        string_view f[9];
+        int nf;
+        do {
+            if (cur >= end) return END;
+            line++;
+            // walk the separator bitmask: delimiters split fields until '\n'
+            nf = 0;
+            bool overflow = false;
+            const char* fieldBegin = cur;
+            const char* p = nextSeparator();
+            for (; p < end && *p != '\n'; p = nextSeparator()) {
+                if (nf < 9) f[nf++] = string_view(fieldBegin, p - fieldBegin);
+                else overflow = true;
+                fieldBegin = p + 1;
+            }
+            const char* rowEnd = (p > fieldBegin && p[-1] == '\r') ? p - 1 : p;
+            bool blank = nf == 0 && rowEnd == fieldBegin;
+            if (nf < 9) f[nf++] = string_view(fieldBegin, rowEnd - fieldBegin);
+            else overflow = true;
+            cur = p < end ? p + 1 : end;
+            if (blank) continue;
+            if (overflow || nf < 5) return BAD_ROW;
+            break;
+        } while (true);
+        for (int i = nf; i < 9; ++i) f[i] = string_view();
+
+        if (!parseVehicleType(f[0], rec.type)) return BAD_ROW;
+        if (f[1].empty() || !toInt(f[1], rec.id) || !toInt(f[4], rec.year) ||
+            !toInt(f[6], rec.battery) || !toInt(f[7], rec.speed) || !toInt(f[8], rec.range))
+            return BAD_ROW;
+        rec.manufacturer = f[2];
+        rec.model = f[3];
+        rec.fuel = f[5];
+        return ROW;
     }
 };
 
-/* VehicleRegistry: manages array of Vehicle* */
+/* VehicleRegistry: owns the fleet, indexed by vehicleID, and serves lookups
+   from many threads while registrations continue. IDs are hashed onto shards;
+   each shard has its own reader-writer lock, ID index and per-type slab pools
+   (the vehicles live there until the registry is destroyed), so lookups only
+   share a lock with other lookups on the same shard and registrations only
+   exclude the shard they land in. Registration order (forEach, displayAll and
+   the optional columnar copy) is kept in a separate list under its own lock,
+   taken after the shard lock is released. Vehicles are not modified after
+   registration, so a pointer from findById stays valid and readable without
+   holding any lock. */
 class VehicleRegistry {
 private:
-    Vehicle* vehicles[100];
-    int total;
+    typedef tuple<SlabPool<Car>, SlabPool<ElectricCar>, SlabPool<SportsCar>,
+                  SlabPool<FlyingCar>, SlabPool<Sedan>, SlabPool<SUV>> Pools;
+
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        VehicleIdIndex index; // ID -> position in slots
+        vector<Vehicle*> slots;
+        Pools pools;
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    uint32_t shardMask;
+    mutable shared_mutex orderLock; // guards vehicles, attributes and columns
+    vector<Vehicle*> vehicles;      // registration order
+    FleetAttributeIndex attributes; // manufacturer / model / year, by position in vehicles
+    unique_ptr<FleetColumns> columns; // optional, see enableColumns()
+
+    template <class T> struct TypeTag { typedef T type; };
+
+    // calls make(TypeTag<T>(), id, constructor arguments...) for the class of r
+    template <class F>
+    static Vehicle* dispatchRecord(const FleetRecord& r, F make) {
+        string_view manu = r.manufacturer, mod = r.model, fuel = r.fuel;
+        switch (r.type) {
+            case VehicleType::Car: return make(TypeTag<Car>(), r.id, manu, mod, r.year, fuel);
+            case VehicleType::ElectricCar: return make(TypeTag<ElectricCar>(), r.id, manu, mod, r.year, fuel, r.battery);
+            case VehicleType::SportsCar:
+                return make(TypeTag<SportsCar>(), r.id, manu, mod, r.year, fuel, r.battery, r.speed);
+            case VehicleType::FlyingCar: return make(TypeTag<FlyingCar>(), r.id, manu, mod, r.year, fuel, r.range);
+            case VehicleType::Sedan: return make(TypeTag<Sedan>(), r.id, manu, mod, r.year, fuel);
+            case VehicleType::SUV: return make(TypeTag<SUV>(), r.id, manu, mod, r.year, fuel);
+        }
+        return nullptr;
+    }
+
+    // s.lock held exclusively; nullptr if id is taken
+    template <class T, class... Args>
+    T* createInShard(Shard& s, int id, Args&&... args) {
+        if (!s.index.insert(id, (uint32_t)s.slots.size())) return nullptr;
+        T* v = get<SlabPool<T>>(s.pools).create(id, std::forward<Args>(args)...);
+        s.slots.push_back(v);
+        return v;
+    }
+
+    // orderLock held exclusively
+    template <class T>
+    void appendInOrder(T* v) {
+        attributes.add((uint32_t)vehicles.size(), v->getManufacturer(), v->getModel(), v->getYear());
+        vehicles.push_back(v);
+        if (columns) columns->append(*v);
+    }
+
+    // a different mix than VehicleIdIndex::home, so each shard's table still
+    // sees well-spread IDs
+    Shard& shardOf(int id) const {
+        uint32_t h = (uint32_t)id * 0x85EBCA6Bu;
+        return *shards[(h ^ (h >> 16)) & shardMask];
+    }
 
 public:
-    VehicleRegistry() : total(0) {
+    static const size_t DEFAULT_SHARDS = 16;
+
+    // shardCount is rounded up to a power of two
+    explicit VehicleRegistry(bool preload = true, size_t shardCount = DEFAULT_SHARDS) {
+        size_t n = 1;
+        while (n < shardCount) n *= 2;
+        for (size_t i = 0; i < n; ++i) shards.emplace_back(new Shard());
+        shardMask = (uint32_t)(n - 1);
+        if (!preload) return;
         // preload 3 sample records so "View All" shows output immediately
-        vehicles[total++] = new Car(201, "Toyota", "Corolla", 2019, "Petrol");
-        vehicles[total++] = new ElectricCar(202, "Tesla", "Model 3", 2021, "Electric", 75);
-        vehicles[total++] = new FlyingCar(203, "AeroMakers", "SkyRider", 2024, "Hybrid", 500);
+        emplace<Car>(201, "Toyota", "Corolla", 2019, "Petrol");
+        emplace<ElectricCar>(202, "Tesla", "Model 3", 2021, "Electric", 75);
+        emplace<FlyingCar>(203, "AeroMakers", "SkyRider", 2024, "Hybrid", 500);
     }
 
-    ~VehicleRegistry() {
-        for (int i = 0; i < total; ++i) delete vehicles[i];
+    VehicleRegistry(const VehicleRegistry&) = delete;
+    VehicleRegistry& operator=(const VehicleRegistry&) = delete;
+
+    // constructs a T in its shard's pool; returns nullptr if the ID is already
+    // registered. Safe to call from several threads at once.
+    template <class T, class... Args>
+    T* emplace(int id, Args&&... args) {
+        Shard& s = shardOf(id);
+        T* v;
+        {
+            unique_lock<shared_mutex> w(s.lock);
+            v = createInShard<T>(s, id, std::forward<Args>(args)...);
+            if (!v) return nullptr;
+        }
+        unique_lock<shared_mutex> w(orderLock);
+        appendInOrder(v);
+        return v;
     }
 
-    void addVehicleInteractive() {
-        if (total >= 100) { cout << "Registry full.\n"; return; }
+    // adds one imported row; nullptr if the ID is already registered
+    Vehicle* addRecord(const FleetRecord& r) {
+        return dispatchRecord(r, [this](auto tag, int id, auto&&... args) -> Vehicle* {
+            return emplace<typename decltype(tag)::type>(id, args...);
+        });
+    }
 
+    // adds n rows under a single acquisition of every lock, for bulk loads;
+    // lookups wait until the batch is in. Returns how many were added
+    // (rows with an ID that is already registered are skipped).
+    size_t addRecords(const FleetRecord* rows, size_t n) {
+        vector<unique_lock<shared_mutex>> held;
+        held.reserve(shards.size());
+        for (auto& s : shards) held.emplace_back(s->lock); // always in shard order
+        unique_lock<shared_mutex> w(orderLock);
+        size_t added = 0;
+        const size_t AHEAD = 8; // ID-table probes are cache misses at fleet scale; overlap them
+        for (size_t i = 0; i < min(AHEAD, n); ++i) shardOf(rows[i].id).index.prefetch(rows[i].id);
+        for (size_t i = 0; i < n; ++i) {
+            if (i + AHEAD < n) shardOf(rows[i + AHEAD].id).index.prefetch(rows[i + AHEAD].id);
+            added += dispatchRecord(rows[i], [this](auto tag, int id, auto&&... args) -> Vehicle* {
+                auto* v = createInShard<typename decltype(tag)::type>(shardOf(id), id, args...);
+                if (v) appendInOrder(v);
+                return v;
+            }) != nullptr;
+        }
+        return added;
+    }
+
+    void reserve(size_t n) {
+        size_t perShard = n / shards.size() + n / shards.size() / 8 + 16; // hashing is not perfectly even
+        for (auto& s : shards) {
+            unique_lock<shared_mutex> w(s->lock);
+            s->index.reserve(perShard);
+            s->slots.reserve(perShard);
+        }
+        unique_lock<shared_mutex> w(orderLock);
+        vehicles.reserve(n);
+        if (columns) columns->reserve(n);
+    }
+
+    // start maintaining a columnar copy of the fleet for filter scans
+    void enableColumns() {
+        unique_lock<shared_mutex> w(orderLock);
+        if (columns) return;
+        columns.reset(new FleetColumns());
+        columns->reserve(vehicles.size());
+        for (const Vehicle* v : vehicles) columns->appendDynamic(v);
+    }
+
+    // FleetColumns::aggregate over the whole fleet, building the columnar copy
+    // on first use; registrations wait until it returns
+    vector<FleetGroup> aggregate(const FleetAggregation& a, unsigned threads = 0) {
+        enableColumns();
+        shared_lock<shared_mutex> r(orderLock);
+        return columns->aggregate(a, threads);
+    }
+
+    // nullptr unless enableColumns() was called; row i is the i-th vehicle
+    // visited by forEach. Not synchronized: read it while no registrations
+    // are in flight.
+    const FleetColumns* fleetColumns() const { return columns.get(); }
+
+    // calls f(const Vehicle&) in registration order; registrations wait until it returns
+    template <class F>
+    void forEach(F f) const {
+        shared_lock<shared_mutex> r(orderLock);
+        for (const Vehicle* v : vehicles) f(*v);
+    }
+
+    // calls f(const Vehicle&) for each vehicle whose manufacturer and model
+    // start with the given prefixes (any case, empty = any) and whose year is
+    // in [minYear, maxYear]; see FleetAttributeIndex::query for the order.
+    // Returns the number of matches.
+    template <class F>
+    size_t findMatching(string_view manufacturer, string_view model, int minYear, int maxYear, F f) const {
+        shared_lock<shared_mutex> r(orderLock);
+        return attributes.query(manufacturer, model, minYear, maxYear,
+                                [&](uint32_t row) { f(*vehicles[row]); });
+    }
+
+    Vehicle* findById(int id) const {
+        Shard& s = shardOf(id);
+        shared_lock<shared_mutex> r(s.lock);
+        long slot = s.index.find(id);
+        return slot < 0 ? nullptr : s.slots[slot];
+    }
+
+    size_t size() const {
+        shared_lock<shared_mutex> r(orderLock);
+        return vehicles.size();
+    }
+
+    size_t shardCount() const { return shards.size(); }
+
+    void addVehicleInteractive() {
         cout << "\nSelect type to add:\n";
         cout << "1. Car\n2. Electric Car\n3. Sports Car\n4. Flying Car\n5. Sedan\n6. SUV\nEnter: ";
         int type; if (!(cin >> type)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout << "Bad input.\n"; return; }
@@ -187,86 +1272,1085 @@ public:
         string manu, mod, fuel;
 
         cout << "ID: "; cin >> id; cin.ignore();
+        if (findById(id)) { cout << "Vehicle with ID " << id << " already exists.\n"; return; }
         cout << "Manufacturer: "; getline(cin, manu);
         cout << "Model: "; getline(cin, mod);
         cout << "Year: "; cin >> year; cin.ignore();
 
+        Vehicle* added = nullptr;
+
         switch (type) {
             case 1:
                 cout << "Fuel Type: "; getline(cin, fuel);
-                vehicles[total++] = new Car(id, manu, mod, year, fuel);
+                added = emplace<Car>(id, manu, mod, year, fuel);
                 break;
             case 2:
                 cout << "Fuel Type: "; getline(cin, fuel);
                 cout << "Battery (kWh): "; cin >> battery; cin.ignore();
-                vehicles[total++] = new ElectricCar(id, manu, mod, year, fuel, battery);
+                added = emplace<ElectricCar>(id, manu, mod, year, fuel, battery);
                 break;
             case 3:
                 cout << "Fuel Type: "; getline(cin, fuel);
                 cout << "Battery (kWh): "; cin >> battery; cin.ignore();
                 cout << "Top Speed (km/h): "; cin >> speed; cin.ignore();
-                vehicles[total++] = new SportsCar(id, manu, mod, year, fuel, battery, speed);
+                added = emplace<SportsCar>(id, manu, mod, year, fuel, battery, speed);
                 break;
             case 4:
                 cout << "Fuel Type: "; getline(cin, fuel);
                 cout << "Flight Range (km): "; cin >> range; cin.ignore();
-                vehicles[total++] = new FlyingCar(id, manu, mod, year, fuel, range);
+                added = emplace<FlyingCar>(id, manu, mod, year, fuel, range);
                 break;
             case 5:
                 cout << "Fuel Type: "; getline(cin, fuel);
-                vehicles[total++] = new Sedan(id, manu, mod, year, fuel);
+                added = emplace<Sedan>(id, manu, mod, year, fuel);
                 break;
             case 6:
                 cout << "Fuel Type: "; getline(cin, fuel);
-                vehicles[total++] = new SUV(id, manu, mod, year, fuel);
+                added = emplace<SUV>(id, manu, mod, year, fuel);
                 break;
             default:
                 cout << "Invalid type.\n";
                 return;
         }
+        // another thread may have registered the ID since the check above
+        if (!added) { cout << "Vehicle with ID " << id << " already exists.\n"; return; }
         cout << "Added.\n";
     }
 
-    void displayAll() const {
-        if (total == 0) { cout << "No vehicles.\n"; return; }
-        cout << "\n-- All Vehicles (" << Vehicle::getTotalVehicles() << ") --\n";
-        for (int i = 0; i < total; ++i) {
-            cout << i+1 << ". ";
-            vehicles[i]->displayDetails();
-            cout << "\n";
-        }
+    // csv uses the --import column layout, so an export can be imported again
+    static const char* const* exportColumns() {
+        static const char* const columns[] = {"type", "id", "manufacturer", "model", "year",
+                                              "fuel", "battery", "speed", "range"};
+        return columns;
+    }
+
+    static void writeRecord(RecordWriter& w, size_t number, const Vehicle& v) {
+        if (w.table()) w.buffer() << number << ". ";
+        w.begin();
+        w.field("type", nullptr, v.typeName());
+        v.writeFields(w);
+        w.end();
+    }
+
+    void displayAll(OutputFormat fmt = OutputFormat::Table, ostream& os = cout) const {
+        shared_lock<shared_mutex> r(orderLock);
+        if (vehicles.empty() && fmt == OutputFormat::Table) { os << "No vehicles.\n"; return; }
+        OutputBuffer out(os);
+        RecordWriter w(out, fmt, ", ", "\n", exportColumns(), 9);
+        if (w.table()) out << "\n-- All Vehicles (" << Vehicle::getTotalVehicles() << ") --\n";
+        w.header();
+        for (size_t i = 0; i < vehicles.size(); ++i) writeRecord(w, i + 1, *vehicles[i]);
+    }
+
+    // prompts for manufacturer / model prefixes and a year range, any of which may be left blank
+    void searchByAttributes(OutputFormat fmt = OutputFormat::Table) const {
+        string manu, mod, from, to;
+        cout << "Manufacturer (prefix, blank = any): "; getline(cin, manu);
+        cout << "Model (prefix, blank = any): "; getline(cin, mod);
+        cout << "Year from (blank = any): "; getline(cin, from);
+        cout << "Year to (blank = any): "; getline(cin, to);
+        int minYear = INT_MIN, maxYear = INT_MAX;
+        auto year = [](const string& s, int& out) {
+            return s.empty() || from_chars(s.data(), s.data() + s.size(), out).ptr == s.data() + s.size();
+        };
+        if (!year(from, minYear) || !year(to, maxYear)) { cout << "Bad input.\n"; return; }
+
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, ", ", "\n", exportColumns(), 9);
+        w.header();
+        size_t shown = 0;
+        findMatching(manu, mod, minYear, maxYear, [&](const Vehicle& v) { writeRecord(w, ++shown, v); });
+        if (w.table()) out << (shown ? "" : "No matching vehicles.\n");
+    }
+
+    // vehicles per manufacturer, average battery of the electric cars and the
+    // highest top speed of the sports cars
+    void showStatistics(OutputFormat fmt = OutputFormat::Table) {
+        static const char* const columnsOut[] = {"statistic", "group", "value"};
+        const uint32_t electric = typeBit(VehicleType::ElectricCar) | typeBit(VehicleType::SportsCar);
+        vector<FleetGroup> perMaker = aggregate(FleetAggregation().by(FleetGroupBy::Manufacturer));
+        vector<FleetGroup> battery = aggregate(FleetAggregation()
+            .where(FleetQuery().types(electric)).measure(FleetMeasure::Battery));
+        vector<FleetGroup> speed = aggregate(FleetAggregation()
+            .where(FleetQuery().types(typeBit(VehicleType::SportsCar))).measure(FleetMeasure::TopSpeed));
+
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, ", ", "\n", columnsOut, 3);
+        if (w.table()) out << "\n-- Fleet Statistics --\n";
+        w.header();
+        // counts and maxima go out as integers, only the mean as a double
+        auto row = [&](const char* statistic, string_view group, auto value) {
+            w.begin();
+            w.field("statistic", "Statistic", statistic);
+            w.field("group", "Group", group);
+            w.field("value", "Value", value);
+            w.end();
+        };
+        shared_lock<shared_mutex> r(orderLock); // manufacturer names
+        for (const FleetGroup& g : perMaker) row("vehicles", columns->manufacturerName(g.key), (long long)g.stats.count);
+        if (!battery.empty()) row("avg_battery_kwh", "ElectricCar+SportsCar", battery[0].stats.mean());
+        if (!speed.empty()) row("max_top_speed_kmh", "SportsCar", (long long)speed[0].stats.max);
+        if (w.table() && perMaker.empty()) out << "No vehicles.\n";
     }
 
     void searchById() const {
         cout << "Enter ID to search: ";
         int id; if (!(cin >> id)) { cout << "Bad input.\n"; return; }
-        for (int i = 0; i < total; ++i) {
-            if (vehicles[i]->getVehicleID() == id) {
-                cout << "Found: ";
-                vehicles[i]->displayDetails();
-                cout << "\n";
-                return;
-            }
+        Vehicle* v = findById(id);
+        if (v) {
+            cout << "Found: ";
+            v->displayDetails();
+            cout << "\n";
+            return;
         }
         cout << "Vehicle with ID " << id << " not found.\n";
     }
 };
 
-int main() {
-    VehicleRegistry registry;
+/* Bulk import: ./VRegistry --import <fleet.csv|fleet.tsv> */
+struct ImportStats {
+    size_t rows = 0;
+    size_t rejected = 0;
+    double seconds = 0;
+};
+
+// streams a mapped CSV/TSV file into the registry; false if the file can't be read
+bool importFleetFile(VehicleRegistry& reg, const char* path, ImportStats& stats, bool verbose = true) {
+    MappedFile file;
+    if (!file.open(path)) {
+        cout << "Cannot read " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    auto t0 = chrono::steady_clock::now();
+    reg.reserve(reg.size() + file.size() / 48); // ~48 bytes per typical row
+    FleetCsvReader reader(file.data(), file.size());
+    FleetRecord rec;
+    const size_t MAX_REPORTED = 5;
+    FleetCsvReader::Result r;
+    while ((r = reader.next(rec)) != FleetCsvReader::END) {
+        stats.rows++;
+        const char* why = nullptr;
+        if (r == FleetCsvReader::BAD_ROW) why = "malformed row";
+        else if (!reg.addRecord(rec)) why = "duplicate ID";
+        if (why) {
+            if (verbose && stats.rejected < MAX_REPORTED)
+                cout << "  line " << reader.lineNumber() << ": " << why << "\n";
+            stats.rejected++;
+        }
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+/* Fleet snapshots: ./VRegistry --load <file> starts from a snapshot instead of
+   the sample records and --save <file> writes one on exit.
+   Layout: "VREG", a version byte and the vehicle count (8 bytes, little
+   endian), then one record per vehicle in registration order:
+     type tag byte (VehicleType)
+     id: zigzag varint, difference from the previous record's id
+     manufacturer, model, fuel: string references (below)
+     year - SNAPSHOT_YEAR_BIAS: zigzag varint
+     battery (ElectricCar, SportsCar), top speed (SportsCar), flight range
+     (FlyingCar): zigzag varints
+   Strings are dictionary-encoded as the file is written: a reference is the
+   varint index of an earlier string, and the next unused index introduces a
+   new one (varint length, then the bytes). Saving and loading are both a
+   single pass, and a loaded dictionary entry is a view into the file. */
+static const char SNAPSHOT_MAGIC[4] = {'V', 'R', 'E', 'G'};
+static const uint8_t SNAPSHOT_VERSION = 1;
+static const size_t SNAPSHOT_HEADER = 13;
+static const int SNAPSHOT_YEAR_BIAS = 2000;
+
+static inline char* putVarint(char* p, uint64_t v) {
+    for (; v >= 0x80; v >>= 7) *p++ = (char)(v | 0x80);
+    *p++ = (char)v;
+    return p;
+}
+
+static inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static inline int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+// a registered vehicle as a row; the string fields point into the vehicle.
+// The registry only holds the six pooled classes, so exact typeid matches
+// replace a chain of dynamic_casts.
+static void recordOf(const Vehicle& v, FleetRecord& r) {
+    r.id = v.getVehicleID();
+    r.year = v.getYear();
+    r.battery = r.speed = r.range = 0;
+    r.manufacturer = v.getManufacturer();
+    r.model = v.getModel();
+    const type_info& t = typeid(v);
+    if (t == typeid(SportsCar)) {
+        const SportsCar& c = static_cast<const SportsCar&>(v);
+        r.type = VehicleType::SportsCar;
+        r.battery = c.getBatteryCapacity();
+        r.speed = c.getTopSpeed();
+    } else if (t == typeid(ElectricCar)) {
+        r.type = VehicleType::ElectricCar;
+        r.battery = static_cast<const ElectricCar&>(v).getBatteryCapacity();
+    } else if (t == typeid(FlyingCar)) {
+        r.type = VehicleType::FlyingCar;
+        r.range = static_cast<const FlyingCar&>(v).getFlightRange();
+    } else if (t == typeid(Sedan)) r.type = VehicleType::Sedan;
+    else if (t == typeid(SUV)) r.type = VehicleType::SUV;
+    else r.type = VehicleType::Car;
+    auto c = dynamic_cast<const Car*>(&v);
+    r.fuel = c ? c->getFuelType() : string_view();
+}
+
+static bool hasBattery(VehicleType t) { return t == VehicleType::ElectricCar || t == VehicleType::SportsCar; }
+
+// writes every registered vehicle to path.tmp, syncs it and renames it over
+// path, so a crash mid-save leaves the previous snapshot intact; false (with a
+// message) if the file can't be written
+bool saveFleetSnapshot(const VehicleRegistry& reg, const char* path, ImportStats& stats) {
+    string tmp = string(path) + ".tmp";
+    ofstream file(tmp, ios::binary | ios::trunc);
+    if (!file) {
+        cout << "Cannot write " << tmp << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    auto t0 = chrono::steady_clock::now();
+    uint64_t count = 0;
+    {
+        OutputBuffer out(file, 1 << 20);
+        char header[SNAPSHOT_HEADER] = {};
+        memcpy(header, SNAPSHOT_MAGIC, 4);
+        header[4] = (char)SNAPSHOT_VERSION;
+        out << string_view(header, SNAPSHOT_HEADER); // count is filled in below
+        unordered_map<string_view, uint32_t> dictionary; // views into the vehicles, locked by forEach
+        FleetRecord r;
+        int prevId = 0;
+        char rec[64];
+        reg.forEach([&](const Vehicle& v) {
+            recordOf(v, r);
+            char* p = rec;
+            *p++ = (char)r.type;
+            p = putVarint(p, zigzag((int64_t)r.id - prevId));
+            prevId = r.id;
+            for (string_view name : {r.manufacturer, r.model, r.fuel}) {
+                auto it = dictionary.find(name);
+                if (it != dictionary.end()) {
+                    p = putVarint(p, it->second);
+                    continue;
+                }
+                p = putVarint(p, dictionary.size());
+                p = putVarint(p, name.size());
+                out << string_view(rec, (size_t)(p - rec)) << name;
+                p = rec;
+                dictionary.emplace(name, (uint32_t)dictionary.size());
+            }
+            p = putVarint(p, zigzag((int64_t)r.year - SNAPSHOT_YEAR_BIAS));
+            if (hasBattery(r.type)) p = putVarint(p, zigzag(r.battery));
+            if (r.type == VehicleType::SportsCar) p = putVarint(p, zigzag(r.speed));
+            if (r.type == VehicleType::FlyingCar) p = putVarint(p, zigzag(r.range));
+            out << string_view(rec, (size_t)(p - rec));
+            count++;
+        });
+    }
+    char countBytes[8];
+    for (int i = 0; i < 8; ++i) countBytes[i] = (char)(count >> (8 * i));
+    file.seekp(5);
+    file.write(countBytes, 8);
+    file.close();
+    bool ok = (bool)file;
+    if (ok) {
+        int fd = open(tmp.c_str(), O_RDONLY);
+        ok = fd >= 0 && fsync(fd) == 0;
+        if (fd >= 0) close(fd);
+    }
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        cout << "Cannot write " << path << ": " << strerror(errno) << "\n";
+        unlink(tmp.c_str());
+        return false;
+    }
+    stats.rows = count;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+/* SnapshotReader: decodes the records of a mapped snapshot one at a time.
+   Every read is bounds-checked; string fields point into the mapping. */
+class SnapshotReader {
+private:
+    const uint8_t* cur;
+    const uint8_t* end;
+    vector<string_view> dictionary;
+    int64_t prevId;
+
+    bool varint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && cur < end; shift += 7) {
+            uint8_t b = *cur++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool number(int64_t lo, int64_t hi, int64_t bias, int64_t& out) {
+        uint64_t raw;
+        if (!varint(raw)) return false;
+        // added as uint64_t: the file is untrusted and signed overflow is undefined.
+        // bias and the bounds are int-sized, so a wrapped sum falls outside [lo, hi]
+        uint64_t v = (uint64_t)unzigzag(raw) + (uint64_t)bias;
+        if (v - (uint64_t)lo > (uint64_t)hi - (uint64_t)lo) return false;
+        out = lo + (int64_t)(v - (uint64_t)lo);
+        return true;
+    }
+
+    bool intField(int& out, int64_t bias = 0) {
+        int64_t v;
+        if (!number(INT_MIN, INT_MAX, bias, v)) return false;
+        out = (int)v;
+        return true;
+    }
+
+    bool text(string_view& out) {
+        uint64_t k, len;
+        if (!varint(k) || k > dictionary.size()) return false;
+        if (k < dictionary.size()) {
+            out = dictionary[k];
+            return true;
+        }
+        if (!varint(len) || len > (uint64_t)(end - cur)) return false;
+        out = string_view((const char*)cur, (size_t)len);
+        cur += len;
+        dictionary.push_back(out);
+        return true;
+    }
+
+public:
+    enum Result { ROW, BAD_ROW, END };
+
+    SnapshotReader(const char* data, size_t size)
+        : cur((const uint8_t*)data), end((const uint8_t*)data + size), prevId(0) {}
+
+    Result next(FleetRecord& r) {
+        if (cur == end) return END;
+        uint8_t type = *cur++;
+        if (type > (uint8_t)VehicleType::SUV) return BAD_ROW;
+        r.type = (VehicleType)type;
+        int64_t id;
+        if (!number(INT_MIN, INT_MAX, prevId, id)) return BAD_ROW;
+        r.id = (int)id;
+        prevId = id;
+        r.battery = r.speed = r.range = 0;
+        if (!text(r.manufacturer) || !text(r.model) || !text(r.fuel) || !intField(r.year, SNAPSHOT_YEAR_BIAS))
+            return BAD_ROW;
+        if (hasBattery(r.type) && !intField(r.battery)) return BAD_ROW;
+        if (r.type == VehicleType::SportsCar && !intField(r.speed)) return BAD_ROW;
+        if (r.type == VehicleType::FlyingCar && !intField(r.range)) return BAD_ROW;
+        return ROW;
+    }
+};
+
+// adds every vehicle of a snapshot, in batches; false (with a message) if the
+// file can't be read or is damaged. Vehicles whose ID is already registered
+// are counted in stats.rejected.
+bool loadFleetSnapshot(VehicleRegistry& reg, const char* path, ImportStats& stats) {
+    MappedFile file;
+    if (!file.open(path)) {
+        cout << "Cannot read " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    auto t0 = chrono::steady_clock::now();
+    const uint8_t* head = (const uint8_t*)file.data();
+    if (file.size() < SNAPSHOT_HEADER || memcmp(head, SNAPSHOT_MAGIC, 4) != 0 || head[4] != SNAPSHOT_VERSION) {
+        cout << path << " is not a fleet snapshot\n";
+        return false;
+    }
+    uint64_t count = 0;
+    for (int i = 0; i < 8; ++i) count |= (uint64_t)head[5 + i] << (8 * i);
+    // every record takes at least 6 bytes, which bounds a damaged count
+    reg.reserve(reg.size() + (size_t)min<uint64_t>(count, (file.size() - SNAPSHOT_HEADER) / 6));
+
+    const size_t BATCH = 4096;
+    vector<FleetRecord> batch(BATCH);
+    SnapshotReader reader(file.data() + SNAPSHOT_HEADER, file.size() - SNAPSHOT_HEADER);
+    SnapshotReader::Result r = SnapshotReader::ROW;
+    while (r == SnapshotReader::ROW) {
+        size_t n = 0;
+        while (n < BATCH && (r = reader.next(batch[n])) == SnapshotReader::ROW) n++;
+        stats.rows += n;
+        stats.rejected += n - reg.addRecords(batch.data(), n);
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    if (r == SnapshotReader::BAD_ROW || stats.rows != count) {
+        cout << path << ": damaged snapshot (record " << stats.rows + 1 << " of " << count << ")\n";
+        return false;
+    }
+    return true;
+}
+
+/* Benchmarks: ./VRegistry --bench <name> [record counts...] */
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void benchIdIndex(size_t n) {
+    mt19937_64 rng(42);
+    vector<int> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = (int)(i * 7 + 1000);   // sparse, non-sequential slots
+    shuffle(ids.begin(), ids.end(), rng);
+
+    VehicleRegistry reg(false);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        reg.emplace<Car>(ids[i], "Toyota", "Corolla", 2019, "Petrol");
+    double insertSec = secondsSince(t0);
+
+    const size_t lookups = 1000000;
+    vector<int> probes(lookups);
+    for (size_t i = 0; i < lookups; ++i) probes[i] = ids[rng() % n];
+    long found = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        if (reg.findById(probes[i])) found++;
+    double lookupSec = secondsSince(t0);
+
+    bool dup = reg.emplace<Car>(ids[0], "Dup", "Dup", 2000, "Petrol") == nullptr;
+
+    cout << "records=" << n
+         << "  insert: " << (long)(n / insertSec) << " ops/s"
+         << "  lookup: " << (long)(lookups / lookupSec) << " ops/s"
+         << "  (hits " << found << "/" << lookups << ", duplicate rejected: " << (dup ? "yes" : "no") << ")\n";
+}
+
+// 10M-style bulk load + teardown: per-object new/delete vs the per-type slab pools
+static void benchPool(size_t n) {
+    auto t0 = chrono::steady_clock::now();
+    {
+        vector<Vehicle*> heap;
+        heap.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            int id = (int)i;
+            switch (i % 3) {
+                case 0: heap.push_back(new Car(id, "Toyota", "Corolla", 2019, "Petrol")); break;
+                case 1: heap.push_back(new ElectricCar(id, "Tesla", "Model 3", 2021, "Electric", 75)); break;
+                default: heap.push_back(new FlyingCar(id, "AeroMakers", "SkyRider", 2024, "Hybrid", 500)); break;
+            }
+        }
+        double loadSec = secondsSince(t0);
+        t0 = chrono::steady_clock::now();
+        for (Vehicle* v : heap) delete v;
+        double freeSec = secondsSince(t0);
+        cout << "new/delete   records=" << n << "  load: " << loadSec << " s  destroy: " << freeSec
+             << " s  allocations: " << n << "\n";
+    }
+
+    t0 = chrono::steady_clock::now();
+    {
+        SlabPool<Car> cars;
+        SlabPool<ElectricCar> electricCars;
+        SlabPool<FlyingCar> flyingCars;
+        vector<Vehicle*> pooled;
+        pooled.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            int id = (int)i;
+            switch (i % 3) {
+                case 0: pooled.push_back(cars.create(id, "Toyota", "Corolla", 2019, "Petrol")); break;
+                case 1: pooled.push_back(electricCars.create(id, "Tesla", "Model 3", 2021, "Electric", 75)); break;
+                default: pooled.push_back(flyingCars.create(id, "AeroMakers", "SkyRider", 2024, "Hybrid", 500)); break;
+            }
+        }
+        double loadSec = secondsSince(t0);
+        size_t slabs = cars.slabCount() + electricCars.slabCount() + flyingCars.slabCount();
+        t0 = chrono::steady_clock::now();
+        cars.clear();
+        electricCars.clear();
+        flyingCars.clear();
+        double freeSec = secondsSince(t0);
+        cout << "slab pools   records=" << n << "  load: " << loadSec << " s  destroy: " << freeSec
+             << " s  allocations: " << slabs << "\n";
+    }
+}
+
+// filter scans: columnar store vs walking Vehicle* with dynamic_cast + getters
+static void benchScan(size_t n) {
+    mt19937 rng(7);
+    VehicleRegistry reg(false);
+    reg.enableColumns();
+    for (size_t i = 0; i < n; ++i) {
+        int id = (int)i, yr = 2000 + (int)(rng() % 26);
+        int batt = 40 + (int)(rng() % 61), speed = 150 + (int)(rng() % 200), range = 200 + (int)(rng() % 700);
+        switch (rng() % 6) {
+            case 0: reg.emplace<Car>(id, "Toyota", "Corolla", yr, "Petrol"); break;
+            case 1: reg.emplace<ElectricCar>(id, "Tesla", "Model 3", yr, "Electric", batt); break;
+            case 2: reg.emplace<SportsCar>(id, "Porsche", "Taycan", yr, "Electric", batt, speed); break;
+            case 3: reg.emplace<FlyingCar>(id, "AeroMakers", "SkyRider", yr, "Hybrid", range); break;
+            case 4: reg.emplace<Sedan>(id, "Honda", "City", yr, "Petrol"); break;
+            default: reg.emplace<SUV>(id, "Mahindra", "XUV700", yr, "Diesel"); break;
+        }
+    }
+    const FleetColumns& cols = *reg.fleetColumns();
+
+    // "all ElectricCars (incl. SportsCars) with battery > 70 kWh"
+    auto t0 = chrono::steady_clock::now();
+    size_t ptrEv = 0;
+    reg.forEach([&](const Vehicle& v) {
+        const ElectricCar* e = dynamic_cast<const ElectricCar*>(&v);
+        if (e && e->getBatteryCapacity() > 70) ptrEv++;
+    });
+    double ptrEvSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t colEv = cols.count(FleetQuery()
+        .types(typeBit(VehicleType::ElectricCar) | typeBit(VehicleType::SportsCar))
+        .battery(71));
+    double colEvSec = secondsSince(t0);
+
+    // "vehicles built after 2020"
+    t0 = chrono::steady_clock::now();
+    size_t ptrYear = 0;
+    reg.forEach([&](const Vehicle& v) { if (v.getYear() > 2020) ptrYear++; });
+    double ptrYearSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t colYear = cols.count(FleetQuery().year(2021));
+    double colYearSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t selected = cols.select(FleetQuery().year(2021)).size();
+    double selectSec = secondsSince(t0);
+
+    cout << "records=" << n << "\n"
+         << "  EV battery > 70   pointers: " << ptrEvSec * 1000 << " ms  columns: " << colEvSec * 1000
+         << " ms  (" << ptrEv << " / " << colEv << " matches)\n"
+         << "  year > 2020       pointers: " << ptrYearSec * 1000 << " ms  columns: " << colYearSec * 1000
+         << " ms  (" << ptrYear << " / " << colYear << " matches)\n"
+         << "  select year>2020  columns: " << selectSec * 1000 << " ms  (" << selected << " rows)\n";
+}
+
+// generated fleet file: raw tokenizer throughput and end-to-end import rate
+static void benchImport(size_t n) {
+    const char* path = "/tmp/VRegistry-import-bench.csv";
+    FILE* out = fopen(path, "w");
+    if (!out) { cout << "cannot write " << path << "\n"; return; }
+    static const char* const rows[] = {
+        "Car,%d,Toyota,Corolla,%d,Petrol,,,\n",
+        "ElectricCar,%d,Tesla,Model 3,%d,Electric,75,,\n",
+        "SportsCar,%d,Porsche,Taycan Turbo S,%d,Electric,93,260,\n",
+        "FlyingCar,%d,AeroMakers,SkyRider,%d,Hybrid,,,500\n",
+        "Sedan,%d,Honda,City,%d,Petrol,,,\n",
+        "SUV,%d,Mahindra,XUV700,%d,Diesel,,,\n"};
+    fputs("type,id,manufacturer,model,year,fuel,battery,speed,range\n", out);
+    for (size_t i = 0; i < n; ++i) fprintf(out, rows[i % 6], (int)i, 2000 + (int)(i % 26));
+    fclose(out);
+
+    MappedFile file;
+    file.open(path);
+    auto t0 = chrono::steady_clock::now();
+    FleetCsvReader reader(file.data(), file.size());
+    FleetRecord rec;
+    size_t parsed = 0;
+    long checksum = 0;
+    FleetCsvReader::Result r;
+    while ((r = reader.next(rec)) != FleetCsvReader::END)
+        if (r == FleetCsvReader::ROW) { parsed++; checksum += rec.id + rec.year + (long)rec.model.size(); }
+    double parseSec = secondsSince(t0);
+
+    VehicleRegistry reg(false);
+    ImportStats stats;
+    importFleetFile(reg, path, stats, false);
+    unlink(path);
+
+    cout << "rows=" << n << "  file: " << file.size() / 1e6 << " MB\n"
+         << "  tokenize+parse: " << file.size() / parseSec / 1e9 << " GB/s  ("
+         << (long)(parsed / parseSec) << " rows/s, checksum " << checksum << ")\n"
+         << "  full import:    " << (long)(stats.rows / stats.seconds) << " rows/s  ("
+         << stats.rejected << " rejected)\n";
+}
+
+// 1M-record dump to /dev/null: field-by-field ostream vs the buffered record writer
+static void streamDetails(ostream& os, const Vehicle* v) {
+    if (dynamic_cast<const Sedan*>(v)) os << "[Sedan] ";
+    else if (dynamic_cast<const SUV*>(v)) os << "[SUV] ";
+    os << "ID: " << v->getVehicleID()
+       << ", Manufacturer: " << v->getManufacturer()
+       << ", Model: " << v->getModel()
+       << ", Year: " << v->getYear();
+    if (auto c = dynamic_cast<const Car*>(v)) os << ", Fuel: " << c->getFuelType();
+    if (auto e = dynamic_cast<const ElectricCar*>(v)) os << ", Battery: " << e->getBatteryCapacity() << " kWh";
+    if (auto s = dynamic_cast<const SportsCar*>(v)) os << ", Top Speed: " << s->getTopSpeed() << " km/h";
+    if (auto a = dynamic_cast<const Aircraft*>(v)) os << ", Range: " << a->getFlightRange() << " km";
+}
+
+static void benchDump(size_t n) {
+    VehicleRegistry reg(false);
+    for (size_t i = 0; i < n; ++i) {
+        int id = (int)i, yr = 2000 + (int)(i % 26);
+        switch (i % 6) {
+            case 0: reg.emplace<Car>(id, "Toyota", "Corolla", yr, "Petrol"); break;
+            case 1: reg.emplace<ElectricCar>(id, "Tesla", "Model 3", yr, "Electric", 75); break;
+            case 2: reg.emplace<SportsCar>(id, "Porsche", "Taycan", yr, "Electric", 93, 260); break;
+            case 3: reg.emplace<FlyingCar>(id, "AeroMakers", "SkyRider", yr, "Hybrid", 500); break;
+            case 4: reg.emplace<Sedan>(id, "Honda", "City", yr, "Petrol"); break;
+            default: reg.emplace<SUV>(id, "Mahindra", "XUV700", yr, "Diesel"); break;
+        }
+    }
+    ofstream devnull("/dev/null");
+
+    auto t0 = chrono::steady_clock::now();
+    size_t row = 0;
+    reg.forEach([&](const Vehicle& v) {
+        devnull << ++row << ". ";
+        streamDetails(devnull, &v);
+        devnull << "\n";
+    });
+    devnull.flush();
+    double streamSec = secondsSince(t0);
+    cout << "records=" << n << "\n  ostream field-by-field: " << (long)(n / streamSec) << " records/s\n";
+
+    static const char* const names[] = {"table", "csv", "jsonl"};
+    for (int f = 0; f < 3; ++f) {
+        t0 = chrono::steady_clock::now();
+        reg.displayAll((OutputFormat)f, devnull);
+        devnull.flush();
+        double sec = secondsSince(t0);
+        cout << "  buffered " << names[f] << ":" << string(14 - strlen(names[f]), ' ')
+             << (long)(n / sec) << " records/s\n";
+    }
+}
+
+// lookups mixed with registrations of new IDs from 1..8 threads, with one
+// shard (a single reader-writer lock) and with the default shard count
+static void benchConcurrent(size_t n) {
+    const size_t OPS = 4000000; // per run, split across the threads
+    static const int threadCounts[] = {1, 2, 4, 8};
+    static const int writePercents[] = {0, 5, 50};
+    cout << "records=" << n << "  ops per run=" << OPS << "  hardware threads=" << thread::hardware_concurrency() << "\n";
+    bool consistent = true;
+    for (size_t shards : {(size_t)1, VehicleRegistry::DEFAULT_SHARDS}) {
+        for (int writePct : writePercents) {
+            cout << "  shards=" << shards << (shards < 10 ? " " : "") << "  writes " << writePct << "%:"
+                 << string(writePct < 10 ? 3 : 2, ' ');
+            for (int threads : threadCounts) {
+                long before = Vehicle::getTotalVehicles();
+                size_t added = 0;
+                double sec;
+                {
+                    VehicleRegistry reg(false, shards);
+                    reg.reserve(n + OPS);
+                    for (size_t i = 0; i < n; ++i) reg.emplace<Car>((int)i, "Toyota", "Corolla", 2019, "Petrol");
+                    atomic<size_t> addedTotal(0), hitTotal(0);
+                    vector<thread> workers;
+                    auto t0 = chrono::steady_clock::now();
+                    for (int t = 0; t < threads; ++t) {
+                        workers.emplace_back([&, t]() {
+                            mt19937 rng(1000 + t);
+                            size_t hits = 0, mine = 0;
+                            int nextId = (int)n + t; // each thread registers its own IDs
+                            for (size_t k = OPS / threads; k > 0; --k) {
+                                if ((int)(rng() % 100) < writePct) {
+                                    if (reg.emplace<Sedan>(nextId, "Honda", "City", 2022, "Petrol")) mine++;
+                                    nextId += threads;
+                                } else if (reg.findById((int)(rng() % n))) hits++;
+                            }
+                            addedTotal += mine;
+                            hitTotal += hits;
+                        });
+                    }
+                    for (thread& w : workers) w.join();
+                    sec = secondsSince(t0);
+                    added = addedTotal;
+                    consistent = consistent && reg.size() == n + added &&
+                                 Vehicle::getTotalVehicles() == before + (long)(n + added) &&
+                                 hitTotal + added == OPS / threads * threads;
+                }
+                consistent = consistent && Vehicle::getTotalVehicles() == before;
+                cout << "  " << threads << "t " << (long)(OPS / threads * threads / sec) << " ops/s";
+            }
+            cout << "\n";
+        }
+    }
+    cout << (consistent ? "  (sizes, live counts and hits consistent)\n" : "  INCONSISTENT RESULT\n");
+}
+
+// secondary-index queries vs a full scan with the same predicate
+static bool startsWithFolded(string_view s, string_view prefix) {
+    return s.size() >= prefix.size() && strncasecmp(s.data(), prefix.data(), prefix.size()) == 0;
+}
+
+static void benchAttributes(size_t n) {
+    static const char* const makes[] = {"Toyota", "Honda", "Ford", "Tesla", "Hyundai", "Tata", "Mahindra", "BMW"};
+    static const char* const models[][4] = {
+        {"Corolla", "Camry", "Prius", "RAV4"}, {"City", "Civic", "Accord", "CR-V"},
+        {"Focus", "Fiesta", "Mustang", "Ranger"}, {"Model 3", "Model S", "Model X", "Model Y"},
+        {"i20", "Creta", "Verna", "Tucson"}, {"Nexon", "Harrier", "Punch", "Tiago"},
+        {"XUV700", "Thar", "Scorpio", "Bolero"}, {"M3", "X5", "i4", "Z4"}};
+    mt19937 rng(22);
+    VehicleRegistry reg(false);
+    reg.reserve(n);
+    char make[16], model[16];
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        int yr = 1995 + (int)(rng() % 31);
+        if (rng() % 5) { // 80% from a few popular makes, the rest spread over 500 small ones
+            unsigned m = rng() % 8;
+            reg.emplace<Car>((int)i, makes[m], models[m][rng() % 4], yr, "Petrol");
+        } else {
+            unsigned m = rng() % 500;
+            snprintf(make, sizeof make, "Brand%03u", m);
+            snprintf(model, sizeof model, "Series %u", (unsigned)(rng() % 6));
+            reg.emplace<Car>((int)i, make, model, yr, "Petrol");
+        }
+    }
+    double loadSec = secondsSince(t0);
+    cout << "records=" << n << "  load with indexes: " << (long)(n / loadSec) << " vehicles/s\n";
+
+    struct Query { const char* label; const char* make; const char* model; int lo, hi; };
+    static const Query queries[] = {
+        {"Toyota Corolla", "Toyota", "Corolla", INT_MIN, INT_MAX},
+        {"years 2019-2021", "", "", 2019, 2021},
+        {"make prefix \"T\"", "T", "", INT_MIN, INT_MAX},
+        {"model prefix \"model\"", "", "model", INT_MIN, INT_MAX},
+        {"Tesla Model* 2020", "tesla", "model", 2020, 2020},
+        {"Brand042 2001-2002", "Brand042", "", 2001, 2002},
+        {"Brand042 Series 3 2001", "Brand042", "Series 3", 2001, 2001}};
+    bool agree = true;
+    for (const Query& q : queries) {
+        long sum = 0;
+        t0 = chrono::steady_clock::now();
+        size_t found = reg.findMatching(q.make, q.model, q.lo, q.hi, [&](const Vehicle& v) { sum += v.getVehicleID(); });
+        double indexSec = secondsSince(t0);
+
+        long scanSum = 0;
+        size_t scanned = 0;
+        t0 = chrono::steady_clock::now();
+        reg.forEach([&](const Vehicle& v) {
+            if (v.getYear() >= q.lo && v.getYear() <= q.hi && startsWithFolded(v.getManufacturer(), q.make) &&
+                startsWithFolded(v.getModel(), q.model)) {
+                scanned++;
+                scanSum += v.getVehicleID();
+            }
+        });
+        double scanSec = secondsSince(t0);
+        agree = agree && found == scanned && sum == scanSum;
+        cout << "  " << q.label << ":" << string(24 - strlen(q.label), ' ') << found << " matches  index: "
+             << indexSec * 1e3 << " ms (" << (found ? (long)(indexSec * 1e9 / found) : 0) << " ns/match)  scan: "
+             << scanSec * 1e3 << " ms\n";
+    }
+    cout << (agree ? "  (index and scan agree)\n" : "  INDEX AND SCAN DISAGREE\n");
+}
+
+// cold start: snapshot save / load vs CSV import of the same fleet, with a
+// field-by-field round-trip check and damaged-file checks
+static void benchSnapshot(size_t n) {
+    static const char* const makes[] = {"Toyota", "Honda", "Ford", "Tesla", "Hyundai", "Tata", "Mahindra", "BMW"};
+    static const char* const fuels[] = {"Petrol", "Diesel", "Electric", "Hybrid"};
+    const char* snapPath = "/tmp/VRegistry-bench.vreg";
+    const char* againPath = "/tmp/VRegistry-bench-2.vreg";
+    const char* csvPath = "/tmp/VRegistry-bench.csv";
+    ImportStats saved, loaded, imported, resaved;
+    {
+        mt19937 rng(23);
+        VehicleRegistry reg(false);
+        reg.reserve(n);
+        char model[16];
+        for (size_t i = 0; i < n; ++i) {
+            int id = (int)(i * 3 + rng() % 3), yr = 1995 + (int)(rng() % 31);
+            const char* make = makes[rng() % 8];
+            const char* fuel = fuels[rng() % 4];
+            snprintf(model, sizeof model, "Model %u", (unsigned)(rng() % 40));
+            int batt = 40 + (int)(rng() % 61), speed = 150 + (int)(rng() % 200), range = 200 + (int)(rng() % 700);
+            switch (rng() % 6) {
+                case 0: reg.emplace<Car>(id, make, model, yr, fuel); break;
+                case 1: reg.emplace<ElectricCar>(id, make, model, yr, fuel, batt); break;
+                case 2: reg.emplace<SportsCar>(id, make, model, yr, fuel, batt, speed); break;
+                case 3: reg.emplace<FlyingCar>(id, make, model, yr, fuel, range); break;
+                case 4: reg.emplace<Sedan>(id, make, model, yr, fuel); break;
+                default: reg.emplace<SUV>(id, make, model, yr, fuel); break;
+            }
+        }
+        saveFleetSnapshot(reg, snapPath, saved);
+        ofstream csv(csvPath);
+        reg.displayAll(OutputFormat::Csv, csv);
+    }
+    struct stat snapSt, csvSt;
+    stat(snapPath, &snapSt);
+    stat(csvPath, &csvSt);
+    {
+        VehicleRegistry fromCsv(false);
+        importFleetFile(fromCsv, csvPath, imported, false);
+    }
+    bool ok;
+    {
+        VehicleRegistry fromSnapshot(false);
+        ok = loadFleetSnapshot(fromSnapshot, snapPath, loaded) && saveFleetSnapshot(fromSnapshot, againPath, resaved);
+    }
+
+    // round trip: the encoding is lossless and deterministic, so saving the
+    // loaded fleet again must reproduce the file byte for byte
+    {
+        MappedFile a, b;
+        ok = ok && a.open(snapPath) && b.open(againPath) && a.size() == b.size() &&
+             memcmp(a.data(), b.data(), a.size()) == 0 && loaded.rows == n && loaded.rejected == 0;
+    }
+
+    // damaged files must be refused: cut short, and a bad type tag
+    // each counts only once the damage is on disk and the load has failed
+    bool truncatedRefused = false, taggedRefused = false;
+    cout.setstate(ios::failbit); // silence the loader's messages
+    if (truncate(againPath, snapSt.st_size / 2) == 0) {
+        VehicleRegistry r(false);
+        ImportStats st;
+        truncatedRefused = !loadFleetSnapshot(r, againPath, st);
+    }
+    if (FILE* f = fopen(snapPath, "r+b")) {
+        bool written = fseek(f, (long)SNAPSHOT_HEADER, SEEK_SET) == 0 && fputc(0x7F, f) != EOF;
+        if (fclose(f) == 0 && written) {
+            VehicleRegistry r(false);
+            ImportStats st;
+            taggedRefused = !loadFleetSnapshot(r, snapPath, st);
+        }
+    }
+    bool refused = truncatedRefused && taggedRefused;
+    cout.clear();
+    unlink(snapPath);
+    unlink(againPath);
+    unlink(csvPath);
+
+    cout << "vehicles=" << n << "\n"
+         << "  snapshot: " << snapSt.st_size / 1e6 << " MB (" << (double)snapSt.st_size / n << " bytes/vehicle)"
+         << "  csv: " << csvSt.st_size / 1e6 << " MB\n"
+         << "  save:        " << saved.seconds << " s\n"
+         << "  load:        " << loaded.seconds << " s  (" << (long)(loaded.rows / loaded.seconds) << " vehicles/s)\n"
+         << "  csv import:  " << imported.seconds << " s  (" << (long)(imported.rows / imported.seconds) << " vehicles/s)\n"
+         << (ok ? "  (round trip exact" : "  ROUND TRIP FAILED")
+         << (refused ? ", damaged files refused)\n" : ", DAMAGED FILE ACCEPTED)\n");
+}
+
+// filter / group-by / aggregate over n rows at 1, 2, 4 ... threads. The
+// columns are filled directly: n Vehicle objects (50M by default) would not
+// fit in memory next to them.
+static void benchAggregate(size_t n) {
+    static const char* const makes[] = {"Toyota", "Honda", "Ford", "Tesla", "Hyundai", "Tata", "Mahindra", "BMW"};
+    mt19937 rng(25);
+    FleetColumns cols;
+    cols.reserve(n);
+    char make[16];
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        int id = (int)i, yr = 1995 + (int)(rng() % 31);
+        int batt = 40 + (int)(rng() % 61), speed = 150 + (int)(rng() % 200), range = 200 + (int)(rng() % 700);
+        const char* m = makes[rng() % 8];
+        if (rng() % 5 == 0) { // the rest spread over 500 small makers
+            snprintf(make, sizeof make, "Brand%03u", (unsigned)(rng() % 500));
+            m = make;
+        }
+        switch (rng() % 6) {
+            case 0: cols.append(Car(id, m, "", yr, "Petrol")); break;
+            case 1: cols.append(ElectricCar(id, m, "", yr, "Electric", batt)); break;
+            case 2: cols.append(SportsCar(id, m, "", yr, "Electric", batt, speed)); break;
+            case 3: cols.append(FlyingCar(id, m, "", yr, "Hybrid", range)); break;
+            case 4: cols.append(Sedan(id, m, "", yr, "Petrol")); break;
+            default: cols.append(SUV(id, m, "", yr, "Diesel")); break;
+        }
+    }
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    cout << "rows=" << n << "  cores=" << cores << "  build: " << secondsSince(t0) << " s\n";
+
+    const uint32_t electric = typeBit(VehicleType::ElectricCar) | typeBit(VehicleType::SportsCar);
+    struct Query { const char* label; FleetAggregation a; };
+    const Query queries[] = {
+        {"count per manufacturer", FleetAggregation().by(FleetGroupBy::Manufacturer)},
+        {"count per type", FleetAggregation().by(FleetGroupBy::Type)},
+        {"avg battery, electric", FleetAggregation().where(FleetQuery().types(electric)).measure(FleetMeasure::Battery)},
+        {"max speed, sports cars", FleetAggregation()
+            .where(FleetQuery().types(typeBit(VehicleType::SportsCar))).measure(FleetMeasure::TopSpeed)},
+        {"range by year, 2010+", FleetAggregation().where(FleetQuery().types(typeBit(VehicleType::FlyingCar)).year(2010))
+            .by(FleetGroupBy::Year).measure(FleetMeasure::FlightRange)}};
+    auto same = [](const vector<FleetGroup>& x, const vector<FleetGroup>& y) {
+        if (x.size() != y.size()) return false;
+        for (size_t i = 0; i < x.size(); ++i) {
+            const GroupStats &p = x[i].stats, &q = y[i].stats;
+            if (x[i].key != y[i].key || p.count != q.count || p.sum != q.sum || p.min != q.min || p.max != q.max)
+                return false;
+        }
+        return true;
+    };
+    bool agree = true;
+    for (const Query& q : queries) {
+        vector<FleetGroup> first;
+        cout << "  " << q.label << ":" << string(24 - strlen(q.label), ' ');
+        for (unsigned threads = 1; threads <= max(4u, cores); threads *= 2) {
+            size_t stolen = 0;
+            t0 = chrono::steady_clock::now();
+            vector<FleetGroup> groups = cols.aggregate(q.a, threads, &stolen);
+            double sec = secondsSince(t0);
+            if (threads == 1) {
+                first = groups;
+                uint64_t rows = 0;
+                for (const FleetGroup& g : groups) rows += g.stats.count;
+                agree = agree && rows == cols.count(q.a.filter);
+                cout << groups.size() << " groups";
+            } else {
+                agree = agree && same(first, groups);
+            }
+            cout << "  " << threads << "t " << (long)(n / sec / min(threads, cores)) << " rows/s/core";
+            if (threads > 1) cout << " (" << stolen << " steals)";
+        }
+        cout << "\n";
+    }
+    cout << (agree ? "  (every thread count agrees, counts match the filter)\n" : "  RESULTS DISAGREE\n");
+}
+
+// heap allocations per vehicle while registering, scanning through the
+// getters, searching, dumping and saving / loading a snapshot. The names are
+// longer than std::string keeps in place but within the inline capacity.
+// Needs a build with -DCOUNT_ALLOCATIONS (see allocationCounter.h).
+static void benchAlloc(size_t n) {
+    static const char* const makes[] = {"Toyota", "Mercedes-Benz", "Rolls-Royce Motor Cars", "Tesla", "Mahindra & Mahindra"};
+    static const char* const models[] = {"Corolla", "Range Rover Evoque", "Phantom Extended", "Model S Long Range", "XUV700"};
+    static const char* const fuels[] = {"Petrol", "Diesel", "Electric", "Plug-in Hybrid"};
+    const char* snapPath = "/tmp/VRegistry-alloc.vreg";
+    cout << "vehicles=" << n << "\n";
+    auto measure = [n](const char* label, auto body) {
+        uint64_t before = allocationCount();
+        auto t0 = chrono::steady_clock::now();
+        body();
+        double sec = secondsSince(t0);
+        uint64_t allocs = allocationCount() - before;
+        cout << "  " << label << ":" << string(12 - strlen(label), ' ') << allocs << " allocations ("
+             << (double)allocs / n << " per vehicle)  " << sec * 1e3 << " ms\n";
+    };
+
+    VehicleRegistry reg(false);
+    reg.reserve(n);
+    mt19937 rng(24);
+    measure("register", [&] {
+        for (size_t i = 0; i < n; ++i) {
+            int yr = 1995 + (int)(rng() % 31);
+            const char* make = makes[rng() % 5];
+            const char* model = models[rng() % 5];
+            const char* fuel = fuels[rng() % 4];
+            if (i % 2) reg.emplace<Sedan>((int)i, make, model, yr, fuel);
+            else reg.emplace<ElectricCar>((int)i, make, model, yr, fuel, 40 + (int)(i % 61));
+        }
+    });
+
+    size_t hits = 0;
+    measure("scan", [&] {
+        reg.forEach([&](const Vehicle& v) {
+            auto c = static_cast<const Car*>(&v); // every vehicle here is a Car
+            if (v.getManufacturer() == "Mercedes-Benz" && startsWithFolded(v.getModel(), "range") &&
+                c->getFuelType() == "Plug-in Hybrid")
+                hits++;
+        });
+    });
+    measure("search", [&] {
+        reg.findMatching("rolls", "phantom", 2000, 2020, [&](const Vehicle& v) { hits += v.getModel().size(); });
+    });
+    measure("jsonl dump", [&] {
+        ofstream devnull("/dev/null");
+        reg.displayAll(OutputFormat::Jsonl, devnull);
+    });
+    ImportStats saved, loaded;
+    measure("save", [&] { saveFleetSnapshot(reg, snapPath, saved); });
+    VehicleRegistry again(false);
+    again.reserve(n);
+    measure("load", [&] { loadFleetSnapshot(again, snapPath, loaded); });
+    unlink(snapPath);
+    cout << (hits && loaded.rows == n ? "" : "  UNEXPECTED RESULT\n");
+}
+
+static int runBenchmarks(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "";
+    vector<size_t> sizes;
+    for (int i = 3; i < argc; ++i) sizes.push_back((size_t)strtoull(argv[i], nullptr, 10));
+
+    if (which == "index") {
+        if (sizes.empty()) sizes = {1000, 1000000, 10000000};
+        for (size_t n : sizes) if (n > 0) benchIdIndex(n);
+    } else if (which == "pool") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchPool(n);
+    } else if (which == "scan") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchScan(n);
+    } else if (which == "import") {
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchImport(n);
+    } else if (which == "dump") {
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchDump(n);
+    } else if (which == "concurrent") {
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchConcurrent(n);
+    } else if (which == "attributes") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchAttributes(n);
+    } else if (which == "snapshot") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchSnapshot(n);
+    } else if (which == "aggregate") {
+        if (sizes.empty()) sizes = {50000000};
+        for (size_t n : sizes) if (n > 0) benchAggregate(n);
+    } else if (which == "alloc") {
+        if (!countingAllocations()) {
+            cout << "allocation counts need a build with -DCOUNT_ALLOCATIONS\n";
+            return 1;
+        }
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchAlloc(n);
+    } else {
+        cout << "usage: VRegistry --bench <index|pool|scan|import|dump|concurrent|attributes|snapshot|aggregate|alloc> [record counts...]\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return runBenchmarks(argc, argv);
+
+    OutputFormat format = OutputFormat::Table;
+    if (!formatFromArgs(argc, argv, format, cout)) return 1;
+
+    const char* importPath = nullptr;
+    const char* loadPath = nullptr;
+    const char* savePath = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--import") == 0) importPath = argv[i + 1];
+        else if (strcmp(argv[i], "--load") == 0) loadPath = argv[i + 1];
+        else if (strcmp(argv[i], "--save") == 0) savePath = argv[i + 1];
+    }
+    VehicleRegistry registry(loadPath == nullptr); // a snapshot replaces the sample records
+    if (loadPath) {
+        ImportStats stats;
+        if (!loadFleetSnapshot(registry, loadPath, stats)) return 1;
+        cout << "Loaded " << stats.rows - stats.rejected << " vehicles (" << stats.rejected
+             << " duplicate IDs skipped) in " << stats.seconds << " s\n";
+    }
+    if (importPath) {
+        ImportStats stats;
+        if (!importFleetFile(registry, importPath, stats)) return 1;
+        cout << "Imported " << stats.rows - stats.rejected << " of " << stats.rows << " rows ("
+             << stats.rejected << " rejected) in " << stats.seconds << " s, "
+             << (long)(stats.seconds > 0 ? stats.rows / stats.seconds : 0) << " rows/s\n";
+    }
+
     while (true) {
         cout << "\n--- Vehicle Registry ---\n";
-        cout << "1. Add Vehicle\n2. View All Vehicles\n3. Search by ID\n4. Exit\n";
+        cout << "1. Add Vehicle\n2. View All Vehicles\n3. Search by ID\n4. Search by Manufacturer/Model/Year\n"
+                "5. Fleet Statistics\n6. Exit\n";
         cout << "Choice: ";
 
-        int ch; if (!(cin >> ch)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout << "Invalid.\n"; continue; }
+        int ch; if (!(cin >> ch)) { if (cin.eof()) break; cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout << "Invalid.\n"; continue; }
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
         if (ch == 1) registry.addVehicleInteractive();
-        else if (ch == 2) registry.displayAll();
+        else if (ch == 2) registry.displayAll(format);
         else if (ch == 3) registry.searchById();
-        else if (ch == 4) { cout << "Goodbye.\n"; break; }
-        else cout << "Choose 1-4.\n";
+        else if (ch == 4) registry.searchByAttributes(format);
+        else if (ch == 5) registry.showStatistics(format);
+        else if (ch == 6) { cout << "Goodbye.\n"; break; }
+        else cout << "Choose 1-6.\n";
+    }
+    if (savePath) {
+        ImportStats stats;
+        if (!saveFleetSnapshot(registry, savePath, stats)) return 1;
+        cout << "Saved " << stats.rows << " vehicles to " << savePath << "\n";
     }
     return 0;
 }
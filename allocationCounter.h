@@ -0,0 +1,46 @@
+// allocationCounter.h
+// Counts calls to the global operator new so the benchmarks can report heap
+// allocations per record. Only built with -DCOUNT_ALLOCATIONS: it then
+// replaces the global allocation functions (malloc/free underneath, plus one
+// relaxed atomic increment), which cannot be inline, so the header may be
+// included from just one translation unit of such a build. Without the flag
+// nothing is replaced and countingAllocations() is false.
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<uint64_t> heapAllocations(0);
+
+inline bool countingAllocations() { return true; }
+inline uint64_t allocationCount() { return heapAllocations.load(std::memory_order_relaxed); }
+
+void* operator new(size_t n) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t n) { return operator new(n); }
+
+// out of line, or GCC sees free() applied to the result of operator new
+// wherever a delete is inlined and warns about a mismatch
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept { free(p); }
+
+#else
+
+inline bool countingAllocations() { return false; }
+inline uint64_t allocationCount() { return 0; }
+
+#endif
+
+#endif
@@ -1,52 +1,272 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <condition_variable>
+#include <functional>
+#include <new>
+#include <string_view>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "outputBuffer.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 using namespace std;
 
+/* Money: an amount in minor units (cents) held in an int64_t, so balances,
+   sums and comparisons are exact. Conversions from decimal text or double
+   round half away from zero to the nearest cent. */
+class Money {
+private:
+    int64_t cents;
+    explicit constexpr Money(int64_t c) : cents(c) {}
+
+public:
+    static constexpr int DIGITS = 2;
+    static constexpr int64_t SCALE = 100;
+
+    constexpr Money() : cents(0) {}
+    static constexpr Money fromMinor(int64_t c) { return Money(c); }
+    // largest amount parse() accepts, 10^13 currency units: far enough below
+    // the int64 range that sums of typed-in amounts cannot approach it
+    static constexpr int64_t MAX_PARSED = 1000000000000000;
+
+    static Money fromDouble(double v) { return Money((int64_t)llround(v * SCALE)); }
+    // "12.34", "-5", "0.005" (-> 0.01); false on anything else or beyond MAX_PARSED
+    static bool parse(string_view text, Money& out);
+
+    constexpr int64_t minor() const { return cents; }
+    double toDouble() const { return (double)cents / SCALE; }
+
+    Money operator+(Money o) const { return Money(cents + o.cents); }
+    Money operator-(Money o) const { return Money(cents - o.cents); }
+    Money operator-() const { return Money(-cents); }
+    Money& operator+=(Money o) { cents += o.cents; return *this; }
+    Money& operator-=(Money o) { cents -= o.cents; return *this; }
+    bool operator==(Money o) const { return cents == o.cents; }
+    bool operator!=(Money o) const { return cents != o.cents; }
+    bool operator<(Money o) const { return cents < o.cents; }
+    bool operator<=(Money o) const { return cents <= o.cents; }
+    bool operator>(Money o) const { return cents > o.cents; }
+    bool operator>=(Money o) const { return cents >= o.cents; }
+};
+
+/* Rate: a percentage in fixed point, 1/10000 of a percent per unit
+   (4.5% is 45000). */
+struct Rate {
+    static constexpr int DIGITS = 4;
+    static constexpr int64_t SCALE = 10000;
+    int64_t units;
+
+    static bool parse(string_view text, Rate& out);
+};
+
+// decimal text with at most `digits` fraction digits kept as value * 10^digits;
+// further digits round half away from zero
+bool parseFixed(string_view text, int digits, int64_t& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+    int64_t value = 0;
+    bool any = false, roundUp = false;
+    int frac = -1; // fraction digits seen, -1 before the point
+    for (; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '.' && frac < 0) { frac = 0; continue; }
+        if (c < '0' || c > '9') return false;
+        any = true;
+        if (frac >= digits) {
+            if (frac == digits) roundUp = c >= '5';
+            frac++;
+            continue;
+        }
+        if (__builtin_mul_overflow(value, (int64_t)10, &value) || __builtin_add_overflow(value, (int64_t)(c - '0'), &value))
+            return false;
+        if (frac >= 0) frac++;
+    }
+    if (!any) return false;
+    for (int f = max(frac, 0); f < digits; ++f)
+        if (__builtin_mul_overflow(value, (int64_t)10, &value)) return false;
+    if (roundUp && __builtin_add_overflow(value, (int64_t)1, &value)) return false;
+    out = negative ? -value : value;
+    return true;
+}
+
+bool Money::parse(string_view text, Money& out) {
+    int64_t v;
+    if (!parseFixed(text, DIGITS, v) || v > MAX_PARSED || v < -MAX_PARSED) return false;
+    out = Money(v);
+    return true;
+}
+
+bool Rate::parse(string_view text, Rate& out) { return parseFixed(text, DIGITS, out.units); }
+
+ostream& operator<<(ostream& os, Money m) {
+    char text[48];
+    OutputBuffer::fixedText(text, m.minor(), Money::DIGITS);
+    return os << text;
+}
+
+ostream& operator<<(ostream& os, Rate r) {
+    char text[48];
+    OutputBuffer::fixedText(text, r.units, Rate::DIGITS);
+    return os << text;
+}
+
+// num / den rounded half away from zero; den > 0
+inline int64_t roundDiv(int64_t num, int64_t den) {
+    int64_t q = num / den, r = num % den;
+    if (2 * (r < 0 ? -r : r) >= den) q += num < 0 ? -1 : 1;
+    return q;
+}
+
+// as above, saturated to the int64 range
+inline int64_t roundDiv(__int128 num, int64_t den) {
+    __int128 q = num / den, r = num % den;
+    if (2 * (r < 0 ? -r : r) >= den) q += num < 0 ? -1 : 1;
+    if (q > INT64_MAX) return INT64_MAX;
+    if (q < INT64_MIN) return INT64_MIN;
+    return (int64_t)q;
+}
+
+/* interest on balance at rate percent, scaled by num/den (an FD term in
+   years as months/12), with a single rounding to the cent at the end.
+   Stays in 64-bit integers unless the product would overflow; interest
+   beyond the int64 range saturates rather than wrapping. */
+inline Money interestOn(Money balance, Rate rate, int64_t num = 1, int64_t den = 1) {
+    const int64_t scale = 100 * Rate::SCALE; // percent in rate units
+    int64_t product;
+    if (!__builtin_mul_overflow(balance.minor(), rate.units, &product) &&
+        !__builtin_mul_overflow(product, num, &product))
+        return Money::fromMinor(roundDiv(product, scale * den));
+    __int128 wide;
+    if (__builtin_mul_overflow((__int128)balance.minor() * rate.units, (__int128)num, &wide)) {
+        bool negative = (balance.minor() < 0) ^ (rate.units < 0) ^ (num < 0);
+        return Money::fromMinor(negative ? INT64_MIN : INT64_MAX);
+    }
+    return Money::fromMinor(roundDiv(wide, scale * den));
+}
+
+enum class AccountKind : uint8_t { Basic, Savings, Checking, FixedDeposit };
+
+// everything needed to recreate an account (transaction log "open" records)
+struct AccountSpec {
+    AccountKind kind;
+    int accNo;
+    string holder;
+    Money balance;
+    Rate rate;   // Savings/FD
+    Money limit; // Checking: overdraft limit
+    int term;    // FD: months
+};
+
 // Base Class
 class BankAccount {
 protected:
     int accNo;
     string holderName;
-    double balance;
+    // Money minor units; changed only by atomic read-modify-write, so the
+    // balance can be updated from many threads without a lock
+    atomic<int64_t> balanceMinor;
+
+    // CAS loop: subtracts amt unless that would take the balance below floor
+    // (or past the int64 range, which would otherwise wrap into a credit)
+    bool debitDownTo(Money amt, Money floor) {
+        if (amt <= Money()) return false;
+        int64_t cur = balanceMinor.load(memory_order_relaxed), next;
+        do {
+            if (__builtin_sub_overflow(cur, amt.minor(), &next) || next < floor.minor()) return false;
+        } while (!balanceMinor.compare_exchange_weak(cur, next, memory_order_acq_rel, memory_order_relaxed));
+        return true;
+    }
 
 public:
     // constructor
-    BankAccount(int no, string name, double bal = 0.0) {
+    BankAccount(int no, string name, Money bal = Money()) : balanceMinor(bal.minor()) {
         accNo = no;
         holderName = name;
-        balance = bal;
     }
 
     // encapsulation : keeping balance private to outside world
-    double getBalance() {
-        return balance;
+    Money getBalance() const {
+        return Money::fromMinor(balanceMinor.load(memory_order_acquire));
     }
 
-    virtual void deposit(double amt) {
-        if(amt > 0) {
-            balance += amt;
-            cout << "Deposited: " << amt << " | Balance: " << balance << endl;
+    int getAccNo() const { return accNo; }
+
+    virtual AccountSpec spec() const {
+        return AccountSpec{AccountKind::Basic, accNo, holderName, getBalance(), Rate{0}, Money(), 0};
+    }
+
+    virtual const char* withdrawRefusal() const { return "Not enough balance or wrong amount!"; }
+
+    // silent balance updates (used by Ledger); false when the amount is rejected,
+    // including a credit that would take the balance past the int64 range
+    bool credit(Money amt) {
+        if (amt <= Money()) return false;
+        int64_t cur = balanceMinor.load(memory_order_relaxed), next;
+        do {
+            if (__builtin_add_overflow(cur, amt.minor(), &next)) return false;
+        } while (!balanceMinor.compare_exchange_weak(cur, next, memory_order_acq_rel, memory_order_relaxed));
+        return true;
+    }
+
+    virtual bool debit(Money amt) { return debitDownTo(amt, Money()); }
+
+    // unchecked change, for replaying logged transactions that already passed their checks
+    void adjust(Money delta) { balanceMinor.fetch_add(delta.minor(), memory_order_acq_rel); }
+
+    virtual void deposit(Money amt) {
+        if(credit(amt)) {
+            cout << "Deposited: " << amt << " | Balance: " << getBalance() << "\n";
         } else {
-            cout << "Invalid deposit!" << endl;
+            cout << "Invalid deposit!" << "\n";
         }
     }
 
-    virtual void withdraw(double amt) {
-        if(amt > 0 && amt <= balance) {
-            balance -= amt;
-            cout << "Withdrawn: " << amt << " | Balance: " << balance << endl;
+    virtual void withdraw(Money amt) {
+        if(debit(amt)) {
+            cout << "Withdrawn: " << amt << " | Balance: " << getBalance() << "\n";
         } else {
-            cout << "Not enough balance or wrong amount!" << endl;
+            cout << withdrawRefusal() << "\n";
         }
     }
 
-    virtual void displayInfo() {
-        cout << "\n--- Account Info ---\n";
-        cout << "Acc No: " << accNo << endl;
-        cout << "Holder: " << holderName << endl;
-        cout << "Balance: " << balance << endl;
+    virtual void writeFields(RecordWriter &w) {
+        w.field("acc_no", "Acc No", accNo);
+        w.field("holder", "Holder", holderName);
+        w.decimal("balance", "Balance", getBalance().minor(), Money::DIGITS);
+    }
+
+    void displayInfo(OutputFormat fmt = OutputFormat::Table) {
+        static const char* const columns[] = {"acc_no", "holder", "balance"};
+        OutputBuffer out(cout, 512);
+        RecordWriter w(out, fmt, "\n", "\n", columns, 3);
+        if (w.table()) out << "\n--- Account Info ---\n";
+        w.header();
+        w.begin();
+        writeFields(w);
+        w.end();
     }
 
+    virtual Money interest() const { return Money(); }
+
     // polymorphism - will be overriden
     virtual void calculateInterest() {
         cout << "No interest for base account.\n";
@@ -57,39 +277,63 @@ public:
 
 // Savings Account
 class SavingsAccount : public BankAccount {
-    double interestRate;
+    Rate interestRate;
 public:
-    SavingsAccount(int no, string name, double bal, double rate)
+    SavingsAccount(int no, string name, Money bal, Rate rate)
     : BankAccount(no, name, bal) {
         interestRate = rate;
     }
 
+    AccountSpec spec() const override {
+        return AccountSpec{AccountKind::Savings, accNo, holderName, getBalance(), interestRate, Money(), 0};
+    }
+
+    Money interest() const override { return interestOn(getBalance(), interestRate); }
+
     void calculateInterest() override {
-        double intr = balance * interestRate / 100;
-        cout << "Savings Interest: " << intr << endl;
+        cout << "Savings Interest: " << interest() << "\n";
     }
 };
 
 // Checking Account
 class CheckingAccount : public BankAccount {
-    double overdraftLimit;
+    Money overdraftLimit;
 public:
-    CheckingAccount(int no, string name, double bal, double limit)
+    CheckingAccount(int no, string name, Money bal, Money limit)
     : BankAccount(no, name, bal) {
         overdraftLimit = limit;
     }
 
-    void withdraw(double amt) override {
-        if(amt > 0 && amt <= balance + overdraftLimit) {
-            balance -= amt;
-            cout << "Withdrawn: " << amt << " | Balance: " << balance << endl;
+    AccountSpec spec() const override {
+        return AccountSpec{AccountKind::Checking, accNo, holderName, getBalance(), Rate{0}, overdraftLimit, 0};
+    }
+
+    const char* withdrawRefusal() const override { return "Exceeds overdraft limit!"; }
+
+    // the overdraft limit is checked inside the CAS loop, so concurrent
+    // withdrawals can never take the balance below -overdraftLimit
+    bool debit(Money amt) override { return debitDownTo(amt, -overdraftLimit); }
+
+    // card authorization hold: a lock-free debit
+    bool authorize(Money amt) { return debit(amt); }
+
+    enum class OverdraftStatus { Safe, InOverdraft };
+
+    // wait-free: a single atomic load
+    OverdraftStatus overdraftStatus() const {
+        return getBalance() < Money() ? OverdraftStatus::InOverdraft : OverdraftStatus::Safe;
+    }
+
+    void withdraw(Money amt) override {
+        if(debit(amt)) {
+            cout << "Withdrawn: " << amt << " | Balance: " << getBalance() << "\n";
         } else {
-            cout << "Exceeds overdraft limit!\n";
+            cout << withdrawRefusal() << "\n";
         }
     }
 
     void checkOverdraft() {
-        if(balance < 0) {
+        if(overdraftStatus() == OverdraftStatus::InOverdraft) {
             cout << "Warning: In overdraft zone!\n";
         } else {
             cout << "Account balance is safe.\n";
@@ -100,26 +344,1124 @@ public:
 // Fixed Deposit
 class FixedDepositAccount : public BankAccount {
     int term; // months
-    double rate;
+    Rate rate;
 public:
-    FixedDepositAccount(int no, string name, double bal, int t, double r)
+    FixedDepositAccount(int no, string name, Money bal, int t, Rate r)
     : BankAccount(no, name, bal) {
         term = t;
         rate = r;
     }
 
+    AccountSpec spec() const override {
+        return AccountSpec{AccountKind::FixedDeposit, accNo, holderName, getBalance(), rate, Money(), term};
+    }
+
+    Money interest() const override { return interestOn(getBalance(), rate, term, 12); }
+
     void calculateInterest() override {
-        double intr = balance * (rate/100) * (term/12.0);
-        cout << "FD Interest for " << term << " months: " << intr << endl;
+        cout << "FD Interest for " << term << " months: " << interest() << "\n";
     }
 };
 
-// Menu Driven Program
-int main() {
-    BankAccount *acc = NULL;
-    int choice;
+unique_ptr<BankAccount> makeAccount(const AccountSpec& a) {
+    switch (a.kind) {
+    case AccountKind::Savings:
+        return unique_ptr<BankAccount>(new SavingsAccount(a.accNo, a.holder, a.balance, a.rate));
+    case AccountKind::Checking:
+        return unique_ptr<BankAccount>(new CheckingAccount(a.accNo, a.holder, a.balance, a.limit));
+    case AccountKind::FixedDeposit:
+        return unique_ptr<BankAccount>(new FixedDepositAccount(a.accNo, a.holder, a.balance, a.term, a.rate));
+    default:
+        return unique_ptr<BankAccount>(new BankAccount(a.accNo, a.holder, a.balance));
+    }
+}
 
-    cout << "===== Banking System =====\n";
+enum class TxStatus { Ok, NoAccount, Rejected, NotDurable };
+
+/* Transaction log: an append-only file of the mutations that succeeded, in
+   the order they were applied:
+
+     LogFileHeader (16 bytes), then per record
+     LogRecordHeader | holder name (Open only) | uint64 checksum
+
+   in host byte order. Replaying the log from the start rebuilds every
+   account; a torn record at the end (a crash mid-write) is cut off.
+   Version 2 stores amounts as Money minor units (version 1 had no file
+   header and stored doubles). */
+enum class LogOp : uint8_t { Open = 1, Deposit, Withdraw, Transfer };
+
+struct LogFileHeader {
+    char magic[8]; // "BANKLOG"
+    uint32_t version;
+    uint32_t reserved;
+};
+
+const char LOG_MAGIC[8] = {'B', 'A', 'N', 'K', 'L', 'O', 'G', '\0'};
+const uint32_t LOG_VERSION = 2;
+
+struct LogRecordHeader {
+    uint32_t size;    // whole record in bytes
+    uint8_t op;       // LogOp
+    uint8_t kind;     // Open: AccountKind
+    uint16_t nameLen; // Open: holder name bytes
+    int32_t accNo;
+    int32_t other;    // Transfer: destination account, Open: FD term
+    int64_t amount;   // Money minor units; Open: starting balance
+    int64_t param;    // Open: Savings/FD rate units, Checking overdraft limit
+};
+
+uint64_t logChecksum(const char* p, size_t n) {
+    uint64_t h = 1469598103934665603ull; // FNV-1a
+    for (size_t i = 0; i < n; ++i) h = (h ^ (unsigned char)p[i]) * 1099511628211ull;
+    return h;
+}
+
+struct RecoveryStats {
+    size_t records;
+    size_t discardedBytes; // torn tail removed from the end of the log
+};
+
+/* TransactionLog does group commit: append() only copies a record into
+   memory; commit() blocks until that record is on disk. The first committer
+   to find no flush running writes out everything appended so far with one
+   fdatasync, so concurrent transactions share a flush. */
+class TransactionLog {
+private:
+    int fd;
+    mutex lock;
+    condition_variable flushed;
+    vector<char> pending;   // appended, not yet written
+    vector<char> spare;     // the other buffer, swapped in while flushing
+    uint64_t appended;      // log bytes handed to append()
+    uint64_t durable;       // log bytes known to be on disk
+    bool flushing;
+    bool failed;
+    uint64_t flushCount, recordCount;
+
+    TransactionLog(int f, uint64_t size)
+        : fd(f), appended(size), durable(size), flushing(false), failed(false), flushCount(0), recordCount(0) {}
+
+    static bool writeAll(int fd, const char* p, size_t n) {
+        while (n) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) return false;
+            p += w;
+            n -= (size_t)w;
+        }
+        return true;
+    }
+
+public:
+    typedef function<void(const LogRecordHeader&, string_view name)> Replay;
+
+    // replays path through apply, cuts off a torn tail and opens the log for
+    // appending; a missing file starts an empty log
+    static unique_ptr<TransactionLog> open(const char* path, const Replay& apply, RecoveryStats& stats,
+                                           string& error) {
+        stats = RecoveryStats{0, 0};
+        int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) { error = strerror(errno); return nullptr; }
+        vector<char> data;
+        char chunk[1 << 16];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) != 0) {
+            if (got < 0 && errno == EINTR) continue;
+            if (got < 0) { error = strerror(errno); ::close(fd); return nullptr; }
+            data.insert(data.end(), chunk, chunk + got);
+        }
+
+        LogFileHeader fh;
+        memset(&fh, 0, sizeof(fh));
+        memcpy(fh.magic, LOG_MAGIC, sizeof(fh.magic));
+        fh.version = LOG_VERSION;
+        if (data.size() < sizeof(fh)) {
+            // new log, or a crash while it was being created
+            if (memcmp(data.data(), &fh, data.size()) != 0) {
+                error = "not a transaction log";
+                ::close(fd);
+                return nullptr;
+            }
+            if (ftruncate(fd, 0) != 0 || pwrite(fd, &fh, sizeof(fh), 0) != (ssize_t)sizeof(fh) || fdatasync(fd) != 0) {
+                error = strerror(errno);
+                ::close(fd);
+                return nullptr;
+            }
+            data.assign((const char*)&fh, (const char*)&fh + sizeof(fh));
+        } else if (memcmp(data.data(), &fh, sizeof(fh)) != 0) {
+            error = "not a transaction log, or one written by an older version";
+            ::close(fd);
+            return nullptr;
+        }
+
+        size_t at = sizeof(fh);
+        while (data.size() - at >= sizeof(LogRecordHeader)) {
+            LogRecordHeader h;
+            memcpy(&h, data.data() + at, sizeof(h));
+            size_t body = sizeof(h) + h.nameLen;
+            if (h.size != body + sizeof(uint64_t) || h.size > data.size() - at) break;
+            if (h.op < (uint8_t)LogOp::Open || h.op > (uint8_t)LogOp::Transfer) break;
+            uint64_t sum;
+            memcpy(&sum, data.data() + at + body, sizeof(sum));
+            if (sum != logChecksum(data.data() + at, body)) break;
+            apply(h, string_view(data.data() + at + sizeof(h), h.nameLen));
+            stats.records++;
+            at += h.size;
+        }
+        stats.discardedBytes = data.size() - at;
+        if (stats.discardedBytes && (ftruncate(fd, (off_t)at) != 0 || fdatasync(fd) != 0)) {
+            error = strerror(errno);
+            ::close(fd);
+            return nullptr;
+        }
+        if (lseek(fd, (off_t)at, SEEK_SET) < 0) { error = strerror(errno); ::close(fd); return nullptr; }
+        return unique_ptr<TransactionLog>(new TransactionLog(fd, at));
+    }
+
+    ~TransactionLog() {
+        commit(appended);
+        ::close(fd);
+    }
+
+    TransactionLog(const TransactionLog&) = delete;
+    TransactionLog& operator=(const TransactionLog&) = delete;
+
+    // queues a record; returns its log position for commit()
+    uint64_t append(LogOp op, int accNo, int other, Money amount, int64_t param = 0,
+                    AccountKind kind = AccountKind::Basic, string_view name = string_view()) {
+        if (name.size() > UINT16_MAX) name = name.substr(0, UINT16_MAX);
+        LogRecordHeader h;
+        memset(&h, 0, sizeof(h));
+        h.size = (uint32_t)(sizeof(h) + name.size() + sizeof(uint64_t));
+        h.op = (uint8_t)op;
+        h.kind = (uint8_t)kind;
+        h.nameLen = (uint16_t)name.size();
+        h.accNo = accNo;
+        h.other = other;
+        h.amount = amount.minor();
+        h.param = param;
+
+        lock_guard<mutex> g(lock);
+        size_t start = pending.size();
+        pending.resize(start + h.size);
+        char* p = pending.data() + start;
+        memcpy(p, &h, sizeof(h));
+        memcpy(p + sizeof(h), name.data(), name.size());
+        uint64_t sum = logChecksum(p, sizeof(h) + name.size());
+        memcpy(p + sizeof(h) + name.size(), &sum, sizeof(sum));
+        appended += h.size;
+        recordCount++;
+        return appended;
+    }
+
+    // blocks until the log is durable up to position; false after a write error
+    bool commit(uint64_t position) {
+        unique_lock<mutex> g(lock);
+        while (durable < position && !failed) {
+            if (flushing) {
+                flushed.wait(g);
+                continue;
+            }
+            // become the leader for everything appended so far
+            flushing = true;
+            spare.swap(pending);
+            uint64_t end = appended;
+            g.unlock();
+            bool ok = writeAll(fd, spare.data(), spare.size()) && fdatasync(fd) == 0;
+            spare.clear();
+            g.lock();
+            if (ok) durable = end;
+            else failed = true;
+            flushing = false;
+            flushCount++;
+            flushed.notify_all();
+        }
+        return !failed;
+    }
+
+    uint64_t flushes() { lock_guard<mutex> g(lock); return flushCount; }
+    uint64_t records() { lock_guard<mutex> g(lock); return recordCount; }
+};
+
+/* Ledger: accounts keyed by accNo, safe to use from many threads.
+   Accounts are spread over lock stripes by a hash of accNo; a stripe's mutex
+   guards its map and keeps a transfer's two legs together (balances
+   themselves are atomic, see authorize()). A transfer locks the two stripes
+   in index order, so two opposite transfers cannot deadlock. */
+class Ledger {
+private:
+    static const size_t STRIPES = 1024; // power of two
+
+    struct alignas(64) Stripe {
+        mutex lock;
+        unordered_map<int, unique_ptr<BankAccount>> accounts;
+    };
+
+    unique_ptr<Stripe[]> stripes;
+    atomic<size_t> count;
+    TransactionLog* log; // successful mutations are logged here when set
+
+    static size_t stripeOf(int accNo) {
+        return (size_t)(((uint32_t)accNo * 0x9E3779B9u) >> 22) & (STRIPES - 1);
+    }
+
+    static BankAccount* lookup(Stripe& s, int accNo) {
+        auto it = s.accounts.find(accNo);
+        return it == s.accounts.end() ? nullptr : it->second.get();
+    }
+
+    // log records are facts: replay applies them without re-checking limits,
+    // so the log order only has to be consistent per record, not match the
+    // order concurrent updates hit the balances. The caller waits for
+    // durability after releasing any locks.
+    TxStatus committed(uint64_t position) {
+        return !position || log->commit(position) ? TxStatus::Ok : TxStatus::NotDurable;
+    }
+
+    void adjust(int accNo, Money delta) {
+        Stripe& s = stripes[stripeOf(accNo)];
+        lock_guard<mutex> g(s.lock);
+        if (BankAccount* a = lookup(s, accNo)) a->adjust(delta);
+    }
+
+public:
+    Ledger() : stripes(new Stripe[STRIPES]), count(0), log(nullptr) {}
+
+    void attach(TransactionLog* l) { log = l; }
+
+    // applies one replayed log record (used before a log is attached)
+    void replay(const LogRecordHeader& h, string_view name) {
+        switch ((LogOp)h.op) {
+        case LogOp::Open:
+            open(makeAccount(AccountSpec{(AccountKind)h.kind, h.accNo, string(name), Money::fromMinor(h.amount),
+                                         Rate{h.kind == (uint8_t)AccountKind::Checking ? 0 : h.param},
+                                         Money::fromMinor(h.kind == (uint8_t)AccountKind::Checking ? h.param : 0),
+                                         h.other}));
+            break;
+        case LogOp::Deposit: adjust(h.accNo, Money::fromMinor(h.amount)); break;
+        case LogOp::Withdraw: adjust(h.accNo, -Money::fromMinor(h.amount)); break;
+        case LogOp::Transfer:
+            adjust(h.accNo, -Money::fromMinor(h.amount));
+            adjust(h.other, Money::fromMinor(h.amount));
+            break;
+        }
+    }
+
+    Ledger(const Ledger&) = delete;
+    Ledger& operator=(const Ledger&) = delete;
+
+    // Rejected if an account with the same number exists
+    TxStatus open(unique_ptr<BankAccount> acc) {
+        int no = acc->getAccNo();
+        uint64_t position = 0;
+        {
+            Stripe& s = stripes[stripeOf(no)];
+            lock_guard<mutex> g(s.lock);
+            auto slot = s.accounts.emplace(no, nullptr);
+            if (!slot.second) return TxStatus::Rejected;
+            if (log) {
+                AccountSpec a = acc->spec();
+                int64_t param = a.kind == AccountKind::Checking ? a.limit.minor() : a.rate.units;
+                position = log->append(LogOp::Open, no, a.term, a.balance, param, a.kind, a.holder);
+            }
+            slot.first->second = std::move(acc);
+            count++;
+        }
+        return committed(position);
+    }
+
+    size_t size() const { return count.load(memory_order_relaxed); }
+
+    TxStatus deposit(int accNo, Money amt) {
+        uint64_t position = 0;
+        {
+            Stripe& s = stripes[stripeOf(accNo)];
+            lock_guard<mutex> g(s.lock);
+            BankAccount* a = lookup(s, accNo);
+            if (!a) return TxStatus::NoAccount;
+            if (!a->credit(amt)) return TxStatus::Rejected;
+            if (log) position = log->append(LogOp::Deposit, accNo, 0, amt);
+        }
+        return committed(position);
+    }
+
+    TxStatus withdraw(int accNo, Money amt) {
+        uint64_t position = 0;
+        {
+            Stripe& s = stripes[stripeOf(accNo)];
+            lock_guard<mutex> g(s.lock);
+            BankAccount* a = lookup(s, accNo);
+            if (!a) return TxStatus::NoAccount;
+            if (!a->debit(amt)) return TxStatus::Rejected;
+            if (log) position = log->append(LogOp::Withdraw, accNo, 0, amt);
+        }
+        return committed(position);
+    }
+
+    // all or nothing: rejected if the source cannot cover amt
+    TxStatus transfer(int from, int to, Money amt) {
+        if (from == to) return TxStatus::Rejected;
+        uint64_t position = 0;
+        {
+            size_t i = stripeOf(from), j = stripeOf(to);
+            unique_lock<mutex> first(stripes[min(i, j)].lock);
+            unique_lock<mutex> second;
+            if (i != j) second = unique_lock<mutex>(stripes[max(i, j)].lock);
+            BankAccount* src = lookup(stripes[i], from);
+            BankAccount* dst = lookup(stripes[j], to);
+            if (!src || !dst) return TxStatus::NoAccount;
+            if (amt <= Money() || !src->debit(amt)) return TxStatus::Rejected;
+            if (!dst->credit(amt)) { // the destination would overflow: give the money back
+                src->adjust(amt);
+                return TxStatus::Rejected;
+            }
+            if (log) position = log->append(LogOp::Transfer, from, to, amt);
+        }
+        return committed(position);
+    }
+
+    // stable pointer for the lock-free paths; accounts are never removed
+    BankAccount* handle(int accNo) {
+        Stripe& s = stripes[stripeOf(accNo)];
+        lock_guard<mutex> g(s.lock);
+        return lookup(s, accNo);
+    }
+
+    // card authorization: a CAS debit with no ledger lock (see handle())
+    TxStatus authorize(BankAccount* acc, Money amt) {
+        if (!acc) return TxStatus::NoAccount;
+        if (!acc->debit(amt)) return TxStatus::Rejected;
+        return committed(log ? log->append(LogOp::Withdraw, acc->getAccNo(), 0, amt) : 0);
+    }
+
+    // releases an authorization hold: an atomic credit, also without the ledger lock
+    TxStatus refund(BankAccount* acc, Money amt) {
+        if (!acc) return TxStatus::NoAccount;
+        if (!acc->credit(amt)) return TxStatus::Rejected;
+        return committed(log ? log->append(LogOp::Deposit, acc->getAccNo(), 0, amt) : 0);
+    }
+
+    bool balance(int accNo, Money& out) {
+        return with(accNo, [&](BankAccount& a) { out = a.getBalance(); }) == TxStatus::Ok;
+    }
+
+    // runs f(account) under the account's lock; f must not change the balance
+    // (that would bypass the transaction log)
+    template <class F>
+    TxStatus with(int accNo, F f) {
+        Stripe& s = stripes[stripeOf(accNo)];
+        lock_guard<mutex> g(s.lock);
+        BankAccount* a = lookup(s, accNo);
+        if (!a) return TxStatus::NoAccount;
+        f(*a);
+        return TxStatus::Ok;
+    }
+
+    // calls f(account) for every account, holding one stripe lock at a time
+    template <class F>
+    void forEach(F f) {
+        for (size_t i = 0; i < STRIPES; ++i) {
+            lock_guard<mutex> g(stripes[i].lock);
+            for (auto& a : stripes[i].accounts) f(*a.second);
+        }
+    }
+
+    // sum of all balances, one stripe at a time (not a snapshot under concurrent transfers)
+    Money totalBalance() {
+        Money total;
+        for (size_t i = 0; i < STRIPES; ++i) {
+            lock_guard<mutex> g(stripes[i].lock);
+            for (auto& a : stripes[i].accounts) total += a.second->getBalance();
+        }
+        return total;
+    }
+};
+
+// batched updates and reconciliation sums over arrays of minor units; integer
+// adds are exact and associative, so both loops vectorize and any split of a
+// sum gives the same total
+void applyDeltas(int64_t* __restrict bal, const int64_t* __restrict delta, size_t n) {
+    for (size_t i = 0; i < n; ++i) bal[i] += delta[i];
+}
+
+int64_t sumBalances(const int64_t* bal, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += bal[i];
+    return sum;
+}
+
+/* Interest kernels over contiguous arrays of minor units and rate units.
+   The scalar kernels use interestOn(), so they give the same cents as
+   SavingsAccount::interest() and FixedDepositAccount::interest().
+
+   The SIMD kernels do the same fixed-point division in double lanes, as a
+   multiply by the reciprocal of the divisor d. While balance, rate and term
+   are non-negative and their product p is below 2^48, p is exact and the
+   computed p / d is off by less than 1/(5d). A true quotient rounds up when
+   its fraction is at least 1/2 and is at least 1/d short of 1/2 otherwise,
+   so adding 1/2 + 1/(2d) and truncating gives the same cents as rounding
+   half away from zero. Lanes outside that range take interestOn(). */
+inline int64_t interestAt(const int64_t* bal, const int64_t* rate, const int32_t* term, size_t i) {
+    Money b = Money::fromMinor(bal[i]);
+    return (term ? interestOn(b, Rate{rate[i]}, term[i], 12) : interestOn(b, Rate{rate[i]})).minor();
+}
+
+void savingsInterestScalar(const int64_t* bal, const int64_t* rate, int64_t* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = interestAt(bal, rate, nullptr, i);
+}
+
+void fdInterestScalar(const int64_t* bal, const int64_t* rate, const int32_t* term, int64_t* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = interestAt(bal, rate, term, i);
+}
+
+// recomputes the lanes of out[i], out[i + 1] whose bit is clear in good
+inline void redoLanes(int good, const int64_t* bal, const int64_t* rate, const int32_t* term, int64_t* out, size_t i) {
+    if (good == 3) return;
+    for (size_t k = 0; k < 2; ++k)
+        if (!(good >> k & 1)) out[i + k] = interestAt(bal, rate, term, i + k);
+}
+
+// term is nullptr for savings (no term factor)
+void interestSimd(const int64_t* bal, const int64_t* rate, const int32_t* term, int64_t* out, size_t n) {
+    size_t i = 0;
+    const double divisor = 100.0 * Rate::SCALE * (term ? 12 : 1);
+    const double reciprocal = 1 / divisor, roundUp = 0.5 + 0.5 / divisor;
+    const double exactLimit = 281474976710656.0; // 2^48
+#if defined(__SSE2__)
+    // an integer in [0, 2^52) planted in the mantissa of 2^52 converts exactly, both ways
+    const __m128i magicBits = _mm_set1_epi64x(0x4330000000000000);
+    const __m128d magic = _mm_set1_pd(4503599627370496.0);
+    const __m128d scale = _mm_set1_pd(reciprocal), bias = _mm_set1_pd(roundUp), limit = _mm_set1_pd(exactLimit);
+    const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+    for (; i + 2 <= n; i += 2) {
+        __m128i b = _mm_loadu_si128((const __m128i*)(bal + i));
+        __m128i r = _mm_loadu_si128((const __m128i*)(rate + i));
+        __m128i wide = _mm_srli_epi64(_mm_or_si128(b, r), 52); // zero while both are in [0, 2^52)
+        __m128d p = _mm_mul_pd(_mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(b, magicBits)), magic),
+                               _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(r, magicBits)), magic));
+        if (term) p = _mm_mul_pd(p, _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)(term + i))));
+        __m128d ok = _mm_castsi128_pd(
+            _mm_cmpeq_epi32(_mm_shuffle_epi32(wide, _MM_SHUFFLE(2, 2, 0, 0)), _mm_setzero_si128()));
+        ok = _mm_and_pd(ok, _mm_and_pd(_mm_cmpge_pd(p, zero), _mm_cmplt_pd(p, limit)));
+        // floor(p / d + bias): round to an integer through 2^52, step back if that went up
+        __m128d t = _mm_add_pd(_mm_mul_pd(p, scale), bias);
+        __m128d q = _mm_sub_pd(_mm_add_pd(t, magic), magic);
+        q = _mm_sub_pd(q, _mm_and_pd(_mm_cmpgt_pd(q, t), one));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(q, magic)), magicBits));
+        redoLanes(_mm_movemask_pd(ok), bal, rate, term, out, i);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint64x2_t exactInput = vdupq_n_u64(1ull << 52);
+    const float64x2_t scale = vdupq_n_f64(reciprocal), bias = vdupq_n_f64(roundUp);
+    const float64x2_t limit = vdupq_n_f64(exactLimit), zero = vdupq_n_f64(0);
+    for (; i + 2 <= n; i += 2) {
+        int64x2_t b = vld1q_s64(bal + i), r = vld1q_s64(rate + i);
+        uint64x2_t ok = vcltq_u64(vreinterpretq_u64_s64(vorrq_s64(b, r)), exactInput);
+        float64x2_t p = vmulq_f64(vcvtq_f64_s64(b), vcvtq_f64_s64(r));
+        if (term) p = vmulq_f64(p, vcvtq_f64_s64(vmovl_s32(vld1_s32(term + i))));
+        ok = vandq_u64(ok, vandq_u64(vcgeq_f64(p, zero), vcltq_f64(p, limit)));
+        vst1q_s64(out + i, vcvtq_s64_f64(vrndmq_f64(vaddq_f64(vmulq_f64(p, scale), bias))));
+        redoLanes((int)(vgetq_lane_u64(ok, 0) & 1) | (int)(vgetq_lane_u64(ok, 1) & 2), bal, rate, term, out, i);
+    }
+#else
+    (void)reciprocal;
+    (void)roundUp;
+    (void)exactLimit;
+#endif
+    for (; i < n; ++i) out[i] = interestAt(bal, rate, term, i);
+}
+
+void savingsInterestSimd(const int64_t* bal, const int64_t* rate, int64_t* out, size_t n) {
+    interestSimd(bal, rate, nullptr, out, n);
+}
+
+void fdInterestSimd(const int64_t* bal, const int64_t* rate, const int32_t* term, int64_t* out, size_t n) {
+    interestSimd(bal, rate, term, out, n);
+}
+
+/* InterestBatch: month-end interest for many accounts at once. Each product
+   keeps its accounts in parallel arrays and the kernels above run over the
+   whole product, optionally split across threads. Results are written with
+   one buffered RecordWriter instead of a cout per account. */
+class InterestBatch {
+public:
+    enum class Kernel { Scalar, Simd };
+
+    struct Product {
+        vector<int32_t> accNo;
+        vector<int64_t> balance;  // Money minor units
+        vector<int64_t> rate;     // Rate units
+        vector<int32_t> term;     // FD: months
+        vector<int64_t> interest; // filled by compute()
+
+        size_t size() const { return accNo.size(); }
+    };
+
+    Product savings, fixedDeposit;
+
+    void reserve(size_t savingsCount, size_t fdCount) {
+        for (Product* p : {&savings, &fixedDeposit}) {
+            size_t n = p == &savings ? savingsCount : fdCount;
+            p->accNo.reserve(n);
+            p->balance.reserve(n);
+            p->rate.reserve(n);
+            if (p == &fixedDeposit) p->term.reserve(n);
+        }
+    }
+
+    // accounts without interest (checking, basic) are skipped
+    void add(const AccountSpec& a) {
+        if (a.kind == AccountKind::Savings) {
+            savings.accNo.push_back(a.accNo);
+            savings.balance.push_back(a.balance.minor());
+            savings.rate.push_back(a.rate.units);
+        } else if (a.kind == AccountKind::FixedDeposit) {
+            fixedDeposit.accNo.push_back(a.accNo);
+            fixedDeposit.balance.push_back(a.balance.minor());
+            fixedDeposit.rate.push_back(a.rate.units);
+            fixedDeposit.term.push_back(a.term);
+        }
+    }
+
+    size_t size() const { return savings.size() + fixedDeposit.size(); }
+
+    void compute(Kernel kernel = Kernel::Simd, unsigned threads = 1) {
+        savings.interest.resize(savings.size());
+        fixedDeposit.interest.resize(fixedDeposit.size());
+        if (threads <= 1) {
+            computeRange(kernel, 0, savings.size(), 0, fixedDeposit.size());
+            return;
+        }
+        // contiguous slices, rounded to whole cache lines of output
+        auto cut = [threads](size_t n, unsigned t) { return t == threads ? n : min(n, (n / threads * t) & ~(size_t)7); };
+        vector<thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            size_t s0 = cut(savings.size(), t), s1 = cut(savings.size(), t + 1);
+            size_t f0 = cut(fixedDeposit.size(), t), f1 = cut(fixedDeposit.size(), t + 1);
+            // every worker reads the shared product arrays and writes only its own slices
+            pool.emplace_back([this, kernel, s0, s1, f0, f1] { computeRange(kernel, s0, s1, f0, f1); });
+        }
+        for (thread& th : pool) th.join();
+    }
+
+    static Money total(const Product& p) { return Money::fromMinor(sumBalances(p.interest.data(), p.interest.size())); }
+
+    void report(OutputFormat fmt, ostream& os) const {
+        static const char* const columns[] = {"acc_no", "product", "interest"};
+        OutputBuffer out(os);
+        RecordWriter w(out, fmt, ", ", "\n", columns, 3);
+        if (w.table()) out << "\n--- Month-End Interest ---\n";
+        w.header();
+        const Product* products[] = {&savings, &fixedDeposit};
+        static const char* const names[] = {"Savings", "Fixed Deposit"};
+        for (int k = 0; k < 2; ++k) {
+            const Product& p = *products[k];
+            for (size_t i = 0; i < p.interest.size(); ++i) {
+                w.begin();
+                w.field("acc_no", "Acc No", p.accNo[i]);
+                w.field("product", "Product", names[k]);
+                w.decimal("interest", "Interest", p.interest[i], Money::DIGITS);
+                w.end();
+            }
+        }
+        if (w.table()) {
+            out << "Savings: " << savings.size() << " account(s), total ";
+            out.decimal(total(savings).minor(), Money::DIGITS) << "\n";
+            out << "Fixed Deposit: " << fixedDeposit.size() << " account(s), total ";
+            out.decimal(total(fixedDeposit).minor(), Money::DIGITS) << "\n";
+        }
+    }
+
+private:
+    void computeRange(Kernel kernel, size_t s0, size_t s1, size_t f0, size_t f1) {
+        Product& s = savings;
+        Product& f = fixedDeposit;
+        if (kernel == Kernel::Simd) {
+            savingsInterestSimd(s.balance.data() + s0, s.rate.data() + s0, s.interest.data() + s0, s1 - s0);
+            fdInterestSimd(f.balance.data() + f0, f.rate.data() + f0, f.term.data() + f0, f.interest.data() + f0, f1 - f0);
+        } else {
+            savingsInterestScalar(s.balance.data() + s0, s.rate.data() + s0, s.interest.data() + s0, s1 - s0);
+            fdInterestScalar(f.balance.data() + f0, f.rate.data() + f0, f.term.data() + f0, f.interest.data() + f0, f1 - f0);
+        }
+    }
+};
+
+/* Benchmark: ./banking --bench ledger [accounts] [transactions]
+   The same transaction count is split over 1, 4, 16 and 64 threads; the mix
+   is 40% deposit, 30% withdraw, 30% transfer between random accounts. The
+   final total must equal the opening total plus the net deposits. */
+int benchLedger(size_t accounts, size_t transactions) {
+    static const int threadCounts[] = {1, 4, 16, 64};
+    cout << "accounts=" << accounts << "  transactions=" << transactions
+         << "  hardware threads=" << thread::hardware_concurrency() << "\n";
+    for (int threads : threadCounts) {
+        Ledger ledger;
+        for (size_t i = 0; i < accounts; ++i) {
+            int no = (int)i + 1;
+            if (i % 2)
+                ledger.open(unique_ptr<BankAccount>(
+                    new CheckingAccount(no, "bench", Money::fromMinor(100000), Money::fromMinor(50000))));
+            else ledger.open(unique_ptr<BankAccount>(new SavingsAccount(no, "bench", Money::fromMinor(100000), Rate{40000})));
+        }
+        Money initial = ledger.totalBalance();
+
+        vector<Money> netFlow(threads); // deposits - withdrawals per thread
+        vector<thread> pool;
+        auto t0 = chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1);
+                size_t ops = transactions / threads + ((size_t)t < transactions % threads);
+                Money flow;
+                for (size_t k = 0; k < ops; ++k) {
+                    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                    int a = (int)(x % accounts) + 1, b = (int)((x >> 24) % accounts) + 1;
+                    Money amt = Money::fromMinor((int64_t)((x >> 44) % 20000 + 1));
+                    unsigned kind = (unsigned)(x >> 40) % 10;
+                    if (kind < 4) {
+                        if (ledger.deposit(a, amt) == TxStatus::Ok) flow += amt;
+                    } else if (kind < 7) {
+                        if (ledger.withdraw(a, amt) == TxStatus::Ok) flow -= amt;
+                    } else {
+                        ledger.transfer(a, b, amt);
+                    }
+                }
+                netFlow[t] = flow;
+            });
+        }
+        for (thread& th : pool) th.join();
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        Money expected = initial;
+        for (Money f : netFlow) expected += f;
+        cout << "  threads=" << threads << ": " << (long)(transactions / sec) << " tx/s  ("
+             << sec * 1000 << " ms, balances " << (ledger.totalBalance() == expected ? "consistent" : "INCONSISTENT")
+             << ")\n";
+    }
+    return 0;
+}
+
+/* Benchmark: ./banking --bench log [transactions]
+   Committed transactions/s through the transaction log. First one thread
+   appends batches of k records and commits each batch once; then deposits
+   go through a logged Ledger from 1..256 threads, where group commit forms
+   the batches. */
+int benchLog(size_t transactions) {
+    const char* path = "/tmp/banking-log-bench.log";
+    static const size_t batchSizes[] = {1, 8, 64, 512};
+    static const int threadCounts[] = {1, 4, 16, 64, 256};
+    RecoveryStats stats;
+    string error;
+    cout << "transactions=" << transactions << "  log=" << path << "\n";
+
+    for (size_t batch : batchSizes) {
+        unlink(path);
+        unique_ptr<TransactionLog> log = TransactionLog::open(path, TransactionLog::Replay(), stats, error);
+        if (!log) { cout << "cannot open " << path << ": " << error << "\n"; return 1; }
+        auto t0 = chrono::steady_clock::now();
+        for (size_t done = 0; done < transactions;) {
+            uint64_t position = 0;
+            for (size_t k = 0; k < batch && done < transactions; ++k, ++done)
+                position = log->append(LogOp::Deposit, 1, 0, Money::fromMinor(100));
+            log->commit(position);
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        cout << "  batch=" << batch << ": " << (long)(transactions / sec) << " committed tx/s  ("
+             << log->flushes() << " flushes)\n";
+    }
+
+    for (int threads : threadCounts) {
+        unlink(path);
+        Ledger ledger;
+        unique_ptr<TransactionLog> log = TransactionLog::open(path, TransactionLog::Replay(), stats, error);
+        if (!log) { cout << "cannot open " << path << ": " << error << "\n"; return 1; }
+        for (int t = 0; t < threads; ++t)
+            ledger.open(unique_ptr<BankAccount>(new SavingsAccount(t + 1, "bench", Money(), Rate{40000})));
+        ledger.attach(log.get());
+        uint64_t flushesBefore = log->flushes();
+
+        vector<thread> pool;
+        auto t0 = chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                size_t ops = transactions / threads + ((size_t)t < transactions % threads);
+                for (size_t k = 0; k < ops; ++k) ledger.deposit(t + 1, Money::fromMinor(100));
+            });
+        }
+        for (thread& th : pool) th.join();
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        uint64_t flushes = log->flushes() - flushesBefore;
+        cout << "  threads=" << threads << ": " << (long)(transactions / sec) << " committed tx/s  ("
+             << flushes << " flushes, " << (double)transactions / (flushes ? flushes : 1) << " tx/flush)\n";
+    }
+    unlink(path);
+    return 0;
+}
+
+/* Crash test: ./banking --bench recovery
+   A child process makes logged deposits from several threads and counts the
+   ones whose commit returned; it is killed with SIGKILL mid-stream and a torn
+   half record is appended to the log. Recovery must keep every acknowledged
+   deposit (at most one more per thread may have reached the disk unacknowledged)
+   and drop the torn tail. This covers process crashes; the page cache survives
+   them, so it does not simulate power loss. */
+int benchRecovery() {
+    const char* path = "/tmp/banking-crash-test.log";
+    const int THREADS = 4;
+    unlink(path);
+    atomic<uint64_t>* acked = (atomic<uint64_t>*)mmap(nullptr, sizeof(atomic<uint64_t>) * THREADS,
+                                                       PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (acked == MAP_FAILED) { cout << "mmap failed\n"; return 1; }
+    for (int t = 0; t < THREADS; ++t) new (&acked[t]) atomic<uint64_t>(0);
+
+    pid_t pid = fork();
+    if (pid < 0) { cout << "fork failed\n"; return 1; }
+    if (pid == 0) {
+        Ledger ledger;
+        RecoveryStats stats;
+        string error;
+        unique_ptr<TransactionLog> log = TransactionLog::open(path, TransactionLog::Replay(), stats, error);
+        if (!log) _exit(2);
+        ledger.attach(log.get());
+        for (int t = 0; t < THREADS; ++t)
+            ledger.open(unique_ptr<BankAccount>(new SavingsAccount(t + 1, "crash test", Money(), Rate{40000})));
+        vector<thread> pool;
+        for (int t = 0; t < THREADS; ++t)
+            pool.emplace_back([&, t] {
+                for (;;)
+                    if (ledger.deposit(t + 1, Money::fromMinor(100)) == TxStatus::Ok) acked[t]++;
+            });
+        for (thread& th : pool) th.join();
+        _exit(0);
+    }
+    usleep(300000);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+
+    // a record whose tail never made it to disk
+    LogRecordHeader torn;
+    memset(&torn, 0, sizeof(torn));
+    torn.size = sizeof(torn) + sizeof(uint64_t);
+    torn.op = (uint8_t)LogOp::Deposit;
+    torn.accNo = 1;
+    int fd = ::open(path, O_WRONLY | O_APPEND);
+    bool tornWritten = fd >= 0 && ::write(fd, &torn, 20) == 20;
+    if (fd >= 0) ::close(fd);
+
+    bool ok = tornWritten;
+    Ledger ledger;
+    RecoveryStats stats;
+    string error;
+    {
+        unique_ptr<TransactionLog> log =
+            TransactionLog::open(path, [&](const LogRecordHeader& h, string_view name) { ledger.replay(h, name); },
+                                 stats, error);
+        if (!log) { cout << "recovery failed: " << error << "\n"; return 1; }
+        cout << "recovered " << stats.records << " records, cut " << stats.discardedBytes << " torn bytes\n";
+        ok = ok && stats.discardedBytes == 20;
+        for (int t = 0; t < THREADS; ++t) {
+            Money bal = Money::fromMinor(-1);
+            ledger.balance(t + 1, bal);
+            int64_t n = (int64_t)acked[t].load();
+            bool good = bal.minor() == 100 * n || bal.minor() == 100 * (n + 1);
+            cout << "  account " << t + 1 << ": acknowledged " << n << ", recovered " << bal
+                 << (good ? "" : "  LOST DEPOSITS") << "\n";
+            ok = ok && good;
+        }
+        // the log must accept appends after the cut
+        ledger.attach(log.get());
+        ok = ok && ledger.deposit(1, Money::fromMinor(100)) == TxStatus::Ok;
+        ledger.attach(nullptr);
+    }
+    Money before, after = Money::fromMinor(-1);
+    ledger.balance(1, before);
+    Ledger again;
+    unique_ptr<TransactionLog> log =
+        TransactionLog::open(path, [&](const LogRecordHeader& h, string_view name) { again.replay(h, name); },
+                             stats, error);
+    ok = ok && log && stats.discardedBytes == 0 && again.balance(1, after) && after == before;
+    munmap(acked, sizeof(atomic<uint64_t>) * THREADS);
+    unlink(path);
+    cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
+
+/* Benchmark: ./banking --bench hot [operations] [logged operations]
+   1, 4, 16 and 64 threads authorize and refund on one checking account whose
+   balance keeps hitting the overdraft limit. The card path looks the account
+   up once with Ledger::handle() and then calls Ledger::authorize() and
+   refund(), a CAS with no ledger lock. It runs against the same
+   check-and-subtract under a mutex, and again with a transaction log
+   attached, where every operation waits for its commit. Each run must end on
+   the balance implied by the approved operations without ever passing the
+   limit, and the logged run's log must replay to that balance. */
+int benchHotAccount(size_t operations, size_t loggedOperations) {
+    static const int threadCounts[] = {1, 4, 16, 64};
+    const char* path = "/tmp/banking-hot-bench.log";
+    const Money limit = Money::fromMinor(100000);
+
+    struct LockedAccount {
+        mutex lock;
+        int64_t minor = 0;
+        bool debit(int64_t amt, int64_t floor) {
+            lock_guard<mutex> g(lock);
+            if (minor - amt < floor) return false;
+            minor -= amt;
+            return true;
+        }
+        void credit(int64_t amt) {
+            lock_guard<mutex> g(lock);
+            minor += amt;
+        }
+    };
+    enum Mode { Cas, Mutex, Logged };
+    static const char* const labels[] = {"  cas:    ", "  mutex:  ", "  logged: "};
+
+    cout << "operations=" << operations << "  logged operations=" << loggedOperations
+         << "  hardware threads=" << thread::hardware_concurrency() << "\n";
+    for (int threads : threadCounts) {
+        for (Mode mode : {Cas, Mutex, Logged}) {
+            size_t count = mode == Logged ? loggedOperations : operations;
+            Ledger ledger;
+            RecoveryStats stats;
+            string error;
+            unique_ptr<TransactionLog> log;
+            if (mode == Logged) {
+                unlink(path);
+                log = TransactionLog::open(path, TransactionLog::Replay(), stats, error);
+                if (!log) { cout << "cannot open " << path << ": " << error << "\n"; return 1; }
+                ledger.attach(log.get());
+            }
+            ledger.open(unique_ptr<BankAccount>(new CheckingAccount(1, "hot", Money(), limit)));
+            BankAccount* account = ledger.handle(1);
+            LockedAccount locked;
+            atomic<int64_t> net(0), lowest(0);
+            vector<thread> pool;
+            auto t0 = chrono::steady_clock::now();
+            for (int t = 0; t < threads; ++t) {
+                pool.emplace_back([&, t] {
+                    uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1);
+                    size_t ops = count / threads + ((size_t)t < count % threads);
+                    int64_t flow = 0, low = 0;
+                    for (size_t k = 0; k < ops; ++k) {
+                        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                        int64_t amt = (int64_t)(x >> 40 & 4095) + 1;
+                        // slightly more authorizations than refunds, so the limit is hit
+                        if ((x & 7) < 5) {
+                            bool ok = mode == Mutex ? locked.debit(amt, -limit.minor())
+                                                    : ledger.authorize(account, Money::fromMinor(amt)) != TxStatus::Rejected;
+                            if (ok) flow -= amt;
+                        } else {
+                            if (mode == Mutex) locked.credit(amt);
+                            else ledger.refund(account, Money::fromMinor(amt));
+                            flow += amt;
+                        }
+                        if ((k & 63) == 0 && mode != Mutex) {
+                            low = min(low, account->getBalance().minor());
+                        }
+                    }
+                    net += flow;
+                    int64_t seen = lowest.load();
+                    while (low < seen && !lowest.compare_exchange_weak(seen, low)) {}
+                });
+            }
+            for (thread& th : pool) th.join();
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            int64_t final = mode == Mutex ? locked.minor : account->getBalance().minor();
+            bool ok = final == net.load() && final >= -limit.minor() && lowest.load() >= -limit.minor();
+            cout << "  threads=" << threads << labels[mode] << (long)(count / sec) << " ops/s  (" << sec * 1000
+                 << " ms, final " << Money::fromMinor(final) << ", " << (ok ? "within limit" : "LIMIT BROKEN");
+
+            if (mode == Logged) {
+                uint64_t flushes = log->flushes();
+                ledger.attach(nullptr);
+                log.reset();
+                Ledger replayed;
+                Money balance = Money::fromMinor(-1);
+                unique_ptr<TransactionLog> again =
+                    TransactionLog::open(path, [&](const LogRecordHeader& h, string_view name) { replayed.replay(h, name); },
+                                         stats, error);
+                bool same = again && stats.discardedBytes == 0 && replayed.balance(1, balance) && balance.minor() == final;
+                cout << ", " << flushes << " flushes, " << (same ? "replay matches" : "REPLAY MISMATCH");
+                unlink(path);
+            }
+            cout << ")\n";
+        }
+    }
+    return 0;
+}
+
+/* Benchmark: ./banking --bench interest [accounts]
+   Half savings, half fixed deposit. The baseline is the per-account virtual
+   interest() call; the scalar, SIMD and threaded batch paths must give the
+   same cents. Every 1024th balance is too large for the SIMD fast path, so
+   its fallback is checked too. */
+int benchInterest(size_t n) {
+    vector<unique_ptr<BankAccount>> accounts;
+    accounts.reserve(n);
+    InterestBatch batch;
+    batch.reserve(n - n / 2, n / 2);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        Money bal = Money::fromMinor((int64_t)(x % 10000000) + (i % 1024 == 5 ? (int64_t)1 << 40 : 0));
+        Rate rate{10000 + (int64_t)(x >> 40 & 1023) * 78};
+        int no = (int)i + 1;
+        if (i % 2 == 0) accounts.emplace_back(new SavingsAccount(no, "", bal, rate));
+        else accounts.emplace_back(new FixedDepositAccount(no, "", bal, (int)(x >> 52 & 63) + 1, rate));
+        batch.add(accounts.back()->spec());
+    }
+
+    vector<int64_t> expect(n);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) expect[i] = accounts[i]->interest().minor();
+    double virtSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // accounts alternate savings/FD, so batch row i of a product is account 2i(+1)
+    auto matches = [&] {
+        for (size_t i = 0; i < batch.savings.size(); ++i)
+            if (batch.savings.interest[i] != expect[2 * i]) return false;
+        for (size_t i = 0; i < batch.fixedDeposit.size(); ++i)
+            if (batch.fixedDeposit.interest[i] != expect[2 * i + 1]) return false;
+        return true;
+    };
+    auto run = [&](const char* label, InterestBatch::Kernel k, unsigned threads) {
+        batch.compute(k, threads); // warm up the output arrays
+        int reps = 5;
+        auto t = chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) batch.compute(k, threads);
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t).count() / reps;
+        cout << "  " << label << ": " << (long)(n / sec) << " accounts/s  (" << sec * 1000 << " ms, "
+             << (matches() ? "exact" : "MISMATCH") << ")\n";
+    };
+
+    unsigned hw = max(1u, thread::hardware_concurrency());
+#if defined(__SSE2__)
+    const char* simd = "SSE2";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const char* simd = "NEON";
+#else
+    const char* simd = "none";
+#endif
+    cout << "accounts=" << n << "  simd=" << simd << "  hardware threads=" << hw << "\n"
+         << "  virtual per account: " << (long)(n / virtSec) << " accounts/s  (" << virtSec * 1000 << " ms)\n";
+    run("batch scalar", InterestBatch::Kernel::Scalar, 1);
+    run("batch simd", InterestBatch::Kernel::Simd, 1);
+    string label = "batch simd x" + to_string(max(hw, 4u)) + " threads";
+    run(label.c_str(), InterestBatch::Kernel::Simd, max(hw, 4u));
+    return 0;
+}
+
+// the same loops over double currency units, the baseline for --bench money;
+// the double sum cannot be reordered, so it does not vectorize
+void applyDeltas(double* __restrict bal, const double* __restrict delta, size_t n) {
+    for (size_t i = 0; i < n; ++i) bal[i] += delta[i];
+}
+
+double sumBalances(const double* bal, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += bal[i];
+    return sum;
+}
+
+/* Benchmark: ./banking --bench money [accounts]
+   The same random cent amounts applied as Money minor units and as double
+   currency units: batched balance updates, then a sum-of-balances
+   reconciliation forwards and in a different order. */
+int benchMoney(size_t n) {
+    const int rounds = 10;
+    vector<int64_t> minorBal(n), minorDelta(n);
+    vector<double> doubleBal(n), doubleDelta(n);
+    uint64_t x = 0x2545F4914F6CDD1Dull;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        minorBal[i] = (int64_t)(x % 100000000);
+        minorDelta[i] = (int64_t)(x >> 32 & 0xFFFFF) - 0x80000;
+        doubleBal[i] = Money::fromMinor(minorBal[i]).toDouble();
+        doubleDelta[i] = Money::fromMinor(minorDelta[i]).toDouble();
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) applyDeltas(minorBal.data(), minorDelta.data(), n);
+    double minorUpdate = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) applyDeltas(doubleBal.data(), doubleDelta.data(), n);
+    double doubleUpdate = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    int64_t minorSum = 0;
+    double doubleSum = 0;
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) minorSum = sumBalances(minorBal.data(), n);
+    double minorRecon = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) doubleSum = sumBalances(doubleBal.data(), n);
+    double doubleRecon = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // the same totals in two halves, as two reconciling threads would
+    int64_t minorSplit = sumBalances(minorBal.data() + n / 2, n - n / 2) + sumBalances(minorBal.data(), n / 2);
+    double doubleSplit = sumBalances(doubleBal.data() + n / 2, n - n / 2) + sumBalances(doubleBal.data(), n / 2);
+    size_t drifted = 0;
+    for (size_t i = 0; i < n; ++i) drifted += Money::fromDouble(doubleBal[i]).minor() != minorBal[i];
+
+    Money exact = Money::fromMinor(minorSum);
+    Money viaDouble = Money::fromDouble(doubleSum);
+    double updates = (double)n * rounds;
+    cout << "accounts=" << n << "  rounds=" << rounds << "\n"
+         << "  balance updates: money " << (long)(updates / minorUpdate) << "/s, double "
+         << (long)(updates / doubleUpdate) << "/s\n"
+         << "  reconciliation:  money " << (long)(updates / minorRecon) << " balances/s, double "
+         << (long)(updates / doubleRecon) << " balances/s\n"
+         << "  money total " << exact << (minorSplit == minorSum ? " (same in any order)" : " (ORDER DEPENDENT)") << "\n"
+         << "  double total " << viaDouble << " (off by " << (viaDouble - exact) << ", "
+         << (doubleSplit == doubleSum ? "same" : "different") << " when summed in two halves, "
+         << drifted << " balance(s) drifted off the cent)\n";
+    return 0;
+}
+
+int runBenchmarks(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "";
+    if (which == "ledger") {
+        size_t accounts = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000000;
+        size_t transactions = argc > 4 ? strtoull(argv[4], nullptr, 10) : 8000000;
+        if (accounts == 0 || accounts > INT32_MAX) {
+            cout << "account count must be between 1 and " << INT32_MAX << "\n";
+            return 1;
+        }
+        return benchLedger(accounts, transactions);
+    } else if (which == "log") {
+        return benchLog(argc > 3 ? strtoull(argv[3], nullptr, 10) : 20000);
+    } else if (which == "recovery") {
+        return benchRecovery();
+    } else if (which == "interest") {
+        return benchInterest(argc > 3 ? strtoull(argv[3], nullptr, 10) : 4000000);
+    } else if (which == "hot") {
+        return benchHotAccount(argc > 3 ? strtoull(argv[3], nullptr, 10) : 20000000,
+                               argc > 4 ? strtoull(argv[4], nullptr, 10) : 20000);
+    } else if (which == "money") {
+        return benchMoney(argc > 3 ? strtoull(argv[3], nullptr, 10) : 10000000);
+    }
+    cout << "usage: banking --bench <ledger|log|recovery|interest|money|hot> [counts...]\n";
+    return 1;
+}
+
+// amounts and rates are read as decimal text; anything unparsable reads as 0
+Money readMoney() {
+    string text;
+    Money m;
+    if (!(cin >> text) || !Money::parse(text, m)) m = Money();
+    return m;
+}
+
+Rate readRate() {
+    string text;
+    Rate r{0};
+    if (!(cin >> text) || !Rate::parse(text, r)) r = Rate{0};
+    return r;
+}
+
+// asks for the account type and details; nullptr on a wrong choice
+unique_ptr<BankAccount> readAccount() {
+    int choice;
     cout << "1. Savings Account\n";
     cout << "2. Checking Account\n";
     cout << "3. Fixed Deposit Account\n";
@@ -128,7 +1470,7 @@ int main() {
 
     int no;
     string name;
-    double bal;
+    Money bal;
 
     cout << "Enter Account No: ";
     cin >> no;
@@ -136,72 +1478,157 @@ int main() {
     cin.ignore();
     getline(cin, name);
     cout << "Enter Starting Balance: ";
-    cin >> bal;
+    bal = readMoney();
 
     if(choice == 1) {
-        double rate;
         cout << "Enter Interest Rate (%): ";
-        cin >> rate;
-        acc = new SavingsAccount(no, name, bal, rate);
+        Rate rate = readRate();
+        return unique_ptr<BankAccount>(new SavingsAccount(no, name, bal, rate));
     }
     else if(choice == 2) {
-        double limit;
         cout << "Enter Overdraft Limit: ";
-        cin >> limit;
-        acc = new CheckingAccount(no, name, bal, limit);
+        Money limit = readMoney();
+        return unique_ptr<BankAccount>(new CheckingAccount(no, name, bal, limit));
     }
     else if(choice == 3) {
         int t;
-        double r;
         cout << "Enter Term (months): ";
         cin >> t;
         cout << "Enter Interest Rate (%): ";
-        cin >> r;
-        acc = new FixedDepositAccount(no, name, bal, t, r);
+        Rate r = readRate();
+        return unique_ptr<BankAccount>(new FixedDepositAccount(no, name, bal, t, r));
     }
-    else {
-        cout << "Wrong choice!\n";
-        return 0;
+    cout << "Wrong choice!\n";
+    return nullptr;
+}
+
+// Menu Driven Program
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return runBenchmarks(argc, argv);
+
+    OutputFormat format = OutputFormat::Table;
+    if (!formatFromArgs(argc, argv, format, cout)) return 1;
+
+    Ledger ledger;
+    int current = 0;
+    bool haveAccount = false;
+
+    // --log <file>: keep a transaction log and rebuild the accounts from it
+    unique_ptr<TransactionLog> log;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--log") != 0) continue;
+        RecoveryStats stats;
+        string error;
+        log = TransactionLog::open(argv[i + 1], [&](const LogRecordHeader& h, string_view name) {
+            ledger.replay(h, name);
+            if ((LogOp)h.op == LogOp::Open && !haveAccount) {
+                current = h.accNo;
+                haveAccount = true;
+            }
+        }, stats, error);
+        if (!log) {
+            cout << "Cannot open log " << argv[i + 1] << ": " << error << "\n";
+            return 1;
+        }
+        cout << "Recovered " << ledger.size() << " account(s) from " << stats.records << " log records";
+        if (stats.discardedBytes) cout << " (discarded " << stats.discardedBytes << " bytes of an incomplete record)";
+        cout << "\n";
+        ledger.attach(log.get());
+    }
+
+    cout << "===== Banking System =====\n";
+    if (!haveAccount) {
+        unique_ptr<BankAccount> first = readAccount();
+        if (!first) return 0;
+        current = first->getAccNo();
+        if (ledger.open(std::move(first)) == TxStatus::NotDurable) cout << "Warning: could not write the log!\n";
     }
 
     int act;
     do {
-        cout << "\n=== Menu ===\n";
+        cout << "\n=== Menu (Account " << current << ") ===\n";
         cout << "1. Deposit\n";
         cout << "2. Withdraw\n";
         cout << "3. Show Info\n";
         cout << "4. Calculate Interest\n";
-        cout << "5. Exit\n";
+        cout << "5. Transfer\n";
+        cout << "6. Open Another Account\n";
+        cout << "7. Switch Account\n";
+        cout << "8. Month-End Interest (all accounts)\n";
+        cout << "9. Exit\n";
         cout << "Enter action: ";
-        cin >> act;
+        if (!(cin >> act)) break;
 
         if(act == 1) {
-            double amt;
             cout << "Amount: ";
-            cin >> amt;
-            acc->deposit(amt);
+            Money amt = readMoney();
+            TxStatus st = ledger.deposit(current, amt);
+            Money bal;
+            ledger.balance(current, bal);
+            if (st == TxStatus::Rejected) cout << "Invalid deposit!\n";
+            else cout << "Deposited: " << amt << " | Balance: " << bal << "\n";
+            if (st == TxStatus::NotDurable) cout << "Warning: could not write the log!\n";
         }
         else if(act == 2) {
-            double amt;
             cout << "Amount: ";
-            cin >> amt;
-            acc->withdraw(amt);
+            Money amt = readMoney();
+            TxStatus st = ledger.withdraw(current, amt);
+            Money bal;
+            ledger.balance(current, bal);
+            if (st == TxStatus::Rejected)
+                ledger.with(current, [](BankAccount& a) { cout << a.withdrawRefusal() << "\n"; });
+            else cout << "Withdrawn: " << amt << " | Balance: " << bal << "\n";
+            if (st == TxStatus::NotDurable) cout << "Warning: could not write the log!\n";
         }
         else if(act == 3) {
-            acc->displayInfo();
+            ledger.with(current, [&](BankAccount& a) { a.displayInfo(format); });
         }
         else if(act == 4) {
-            acc->calculateInterest();
+            ledger.with(current, [](BankAccount& a) { a.calculateInterest(); });
         }
         else if(act == 5) {
+            int to;
+            cout << "To Account No: ";
+            cin >> to;
+            cout << "Amount: ";
+            Money amt = readMoney();
+            TxStatus st = ledger.transfer(current, to, amt);
+            if (st == TxStatus::Ok) cout << "Transferred: " << amt << " to account " << to << "\n";
+            else if (st == TxStatus::NoAccount) cout << "No such account!\n";
+            else if (st == TxStatus::NotDurable) cout << "Warning: could not write the log!\n";
+            else cout << "Not enough balance or wrong amount!\n";
+        }
+        else if(act == 6) {
+            unique_ptr<BankAccount> acc = readAccount();
+            if (acc) {
+                int no = acc->getAccNo();
+                TxStatus st = ledger.open(std::move(acc));
+                if (st == TxStatus::Rejected) cout << "Account " << no << " already exists!\n";
+                else current = no;
+                if (st == TxStatus::NotDurable) cout << "Warning: could not write the log!\n";
+            }
+        }
+        else if(act == 7) {
+            int no;
+            cout << "Account No: ";
+            cin >> no;
+            if (ledger.with(no, [](BankAccount&) {}) == TxStatus::Ok) current = no;
+            else cout << "No such account!\n";
+        }
+        else if(act == 8) {
+            InterestBatch batch;
+            ledger.forEach([&](BankAccount& a) { batch.add(a.spec()); });
+            batch.compute();
+            batch.report(format, cout);
+        }
+        else if(act == 9) {
             cout << "Thank you!\n";
         }
         else {
             cout << "Invalid action!\n";
         }
 
-    } while(act != 5);
+    } while(act != 9);
 
-    delete acc;
     return 0;
 }
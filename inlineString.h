@@ -0,0 +1,103 @@
+// inlineString.h
+// Fixed-capacity storage for short record fields (names, titles, codes): up
+// to N bytes live inside the object, so building, copying and reading a field
+// does not touch the heap. A longer value is still kept whole, in a heap
+// block of its own, rather than truncated.
+#ifndef INLINE_STRING_H
+#define INLINE_STRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+template <size_t N>
+class InlineString {
+    static_assert(N >= sizeof(char*) + sizeof(uint32_t) && N < 255, "capacity must hold a heap pointer and fit a byte");
+
+private:
+    static const uint8_t ON_HEAP = 255;
+
+    // a spilled value keeps its pointer and 32-bit size in the first bytes of local
+    alignas(char*) char local[N];
+    uint8_t len; // bytes used in local, or ON_HEAP
+
+    char* heapData() const {
+        char* p;
+        memcpy(&p, local, sizeof p);
+        return p;
+    }
+    uint32_t heapSize() const {
+        uint32_t n;
+        memcpy(&n, local + sizeof(char*), sizeof n);
+        return n;
+    }
+
+    void assign(std::string_view s) {
+        if (s.size() <= N) {
+            if (!s.empty()) memcpy(local, s.data(), s.size());
+            len = (uint8_t)s.size();
+        } else {
+            char* p = new char[s.size()];
+            uint32_t n = (uint32_t)s.size();
+            memcpy(p, s.data(), n);
+            memcpy(local, &p, sizeof p);
+            memcpy(local + sizeof p, &n, sizeof n);
+            len = ON_HEAP;
+        }
+    }
+
+    void take(InlineString& o) {
+        memcpy(local, o.local, N); // the heap pointer, if any, moves with the bytes
+        len = o.len;
+        o.len = 0;
+    }
+
+    void release() {
+        if (len == ON_HEAP) delete[] heapData();
+        len = 0;
+    }
+
+public:
+    InlineString() : len(0) {}
+    InlineString(std::string_view s) { assign(s); }
+    InlineString(const char* s) { assign(std::string_view(s)); }
+    InlineString(const InlineString& o) { assign(o.view()); }
+    InlineString(InlineString&& o) noexcept { take(o); }
+    ~InlineString() { release(); }
+
+    InlineString& operator=(const InlineString& o) {
+        if (this != &o) {
+            release();
+            assign(o.view());
+        }
+        return *this;
+    }
+
+    InlineString& operator=(InlineString&& o) noexcept {
+        if (this != &o) {
+            release();
+            take(o);
+        }
+        return *this;
+    }
+
+    // s may point into this string
+    InlineString& operator=(std::string_view s) {
+        InlineString copy(s);
+        return *this = std::move(copy);
+    }
+    InlineString& operator=(const char* s) { return *this = std::string_view(s); }
+
+    std::string_view view() const {
+        return len == ON_HEAP ? std::string_view(heapData(), heapSize()) : std::string_view(local, len);
+    }
+    operator std::string_view() const { return view(); }
+
+    size_t size() const { return len == ON_HEAP ? heapSize() : len; }
+    bool empty() const { return len == 0; }
+    bool inlined() const { return len != ON_HEAP; }
+    static constexpr size_t capacity() { return N; }
+};
+
+#endif
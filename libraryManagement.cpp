@@ -1,25 +1,134 @@
 // LibraryManagement.cpp
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <limits>
 #include <cctype>
 #include <stdexcept>
 #include <vector>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <queue>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <climits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "outputBuffer.h"
+#include "inlineString.h"
+#include "allocationCounter.h"
 
 using namespace std;
 
-const int MAX_ITEMS = 100;
-
 // Utility functions
-bool isValidISBN(const string &isbn) {
-    // Very simple ISBN validation: only digits (or digits + hyphens) and length 10 or 13 ignoring hyphens
-    string digits;
-    for (char c : isbn) {
-        if (isdigit((unsigned char)c)) digits.push_back(c);
-        else if (c == '-') continue;
-        else return false;
+
+/* ISBN keys: an ISBN-10 or ISBN-13 with a valid check digit, reduced to the
+   ISBN-13 as a number (e.g. "0-306-40615-2" -> 9780306406157); 0 if invalid.
+   Hyphens and spaces are ignored; an ISBN-10 may end in X. */
+
+// ISBN-13 key for the first nine digits of an ISBN-10; sum9 is their ISBN-13
+// weighted sum once prefixed with 978 (weights 3,1,3,...)
+static uint64_t isbn13FromIsbn10(uint64_t first9, int sum9) {
+    return (978000000000ull + first9) * 10 + (10 - (38 + sum9) % 10) % 10;
+}
+
+uint64_t isbnKey(string_view s) {
+    uint64_t value = 0;
+    int n = 0, sum10 = 0, sum13 = 0, digitSum = 0, d = 0;
+    bool x = false;
+    for (char c : s) {
+        if (c == '-' || c == ' ') continue;
+        if (x) return 0; // X is only a final check digit
+        if (c >= '0' && c <= '9') d = c - '0';
+        else if ((c == 'X' || c == 'x') && n == 9) { d = 10; x = true; }
+        else return 0;
+        if (++n > 13) return 0;
+        sum10 += (11 - n) * d;
+        sum13 += (n % 2 ? 1 : 3) * d;
+        digitSum += d;
+        if (!x) value = value * 10 + d;
     }
-    return (digits.length() == 10 || digits.length() == 13);
+    if (n == 13) return sum13 % 10 == 0 ? value : 0;
+    // as ISBN-13 digits 4..12 the first nine swap weights (1 <-> 3)
+    if (n == 10 && sum10 % 11 == 0) return isbn13FromIsbn10(x ? value : value / 10, 4 * digitSum - sum13 - d);
+    return 0;
+}
+
+bool isValidISBN(string_view isbn) {
+    return isbnKey(isbn) != 0;
+}
+
+#if defined(__SSE2__)
+/* isbnKey() for an unpunctuated ISBN-10 or ISBN-13, in registers: the first
+   and last 8 bytes are loaded as one vector (they overlap), all 16 bytes are
+   classified at once, and the check sum and value come from weighted
+   multiply-adds in which the overlapping bytes have weight 0. Anything else
+   (hyphens, spaces, other lengths) goes to the scalar isbnKey(). */
+static uint64_t isbnKeySse2(string_view s) {
+    size_t n = s.size();
+    if (n != 13 && n != 10) return isbnKey(s);
+    __m128i c = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)s.data()),
+                                   _mm_loadl_epi64((const __m128i*)(s.data() + n - 8)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    // an ISBN-10 may end in X (value 10)
+    __m128i x = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('x')),
+                              _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, n == 10 ? -1 : 0));
+    if (_mm_movemask_epi8(_mm_or_si128(digit, x)) != 0xFFFF) return isbnKey(s);
+    bool hasX = _mm_movemask_epi8(x) != 0;
+
+    __m128i d = _mm_or_si128(_mm_andnot_si128(x, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                             _mm_and_si128(x, _mm_set1_epi8(10)));
+    // second half: drop the bytes the first half already covered
+    d = _mm_and_si128(d, n == 13 ? _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, -1, -1, -1, -1, -1)
+                                 : _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, -1, -1));
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(d, zero), hi = _mm_unpackhi_epi8(d, zero);
+
+    __m128i sum = n == 13 ? _mm_add_epi32(_mm_madd_epi16(lo, _mm_setr_epi16(1, 3, 1, 3, 1, 3, 1, 3)),
+                                          _mm_madd_epi16(hi, _mm_setr_epi16(0, 0, 0, 1, 3, 1, 3, 1)))
+                          : _mm_add_epi32(_mm_madd_epi16(lo, _mm_setr_epi16(10, 9, 8, 7, 6, 5, 4, 3)),
+                                          _mm_madd_epi16(hi, _mm_setr_epi16(0, 0, 0, 0, 0, 0, 2, 1)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    int check = _mm_cvtsi128_si32(sum);
+    if (n == 13 ? check % 10 != 0 : check % 11 != 0) return 0;
+
+    // value: pairs of digits, then groups of 4, then the two 8-byte halves
+    __m128i v2 = _mm_packs_epi32(_mm_madd_epi16(lo, _mm_setr_epi16(10, 1, 10, 1, 10, 1, 10, 1)),
+                                 _mm_madd_epi16(hi, _mm_setr_epi16(10, 1, 10, 1, 10, 1, 10, 1)));
+    __m128i v4 = _mm_madd_epi16(v2, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    __m128i v8 = _mm_madd_epi16(_mm_packs_epi32(v4, v4), _mm_setr_epi16(10000, 1, 10000, 1, 0, 0, 0, 0));
+    uint64_t head = (uint32_t)_mm_cvtsi128_si32(v8);
+    uint64_t tail = (uint32_t)_mm_cvtsi128_si32(_mm_shuffle_epi32(v8, _MM_SHUFFLE(1, 1, 1, 1)));
+    if (n == 13) return head * 100000 + tail;
+    // ISBN-10: tail holds the 9th digit and the check digit (10 for X)
+    __m128i s9 = _mm_add_epi32(_mm_madd_epi16(lo, _mm_setr_epi16(3, 1, 3, 1, 3, 1, 3, 1)),
+                               _mm_madd_epi16(hi, _mm_setr_epi16(0, 0, 0, 0, 0, 0, 3, 0)));
+    s9 = _mm_add_epi32(s9, _mm_shuffle_epi32(s9, _MM_SHUFFLE(1, 0, 3, 2)));
+    s9 = _mm_add_epi32(s9, _mm_shuffle_epi32(s9, _MM_SHUFFLE(2, 3, 0, 1)));
+    return isbn13FromIsbn10(head * 10 + (tail - (hasX ? 10 : tail % 10)) / 10, _mm_cvtsi128_si32(s9));
+}
+#endif
+
+// isbnKey() for each of isbns[0..n); returns how many are valid
+size_t isbnKeys(const string_view* isbns, size_t n, uint64_t* keys) {
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+#if defined(__SSE2__)
+        keys[i] = isbnKeySse2(isbns[i]);
+#else
+        keys[i] = isbnKey(isbns[i]);
+#endif
+        valid += keys[i] != 0;
+    }
+    return valid;
 }
 
 void clearInput() {
@@ -27,35 +136,180 @@ void clearInput() {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 }
 
+// Dates are whole days since 1970-01-01 (proleptic Gregorian calendar)
+typedef int32_t Day;
+const Day NO_DAY = INT32_MIN;
+const int LOAN_DAYS = 14; // default loan period
+
+Day daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(Day z, int &y, int &m, int &d) {
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = yoe + era * 400 + (m <= 2);
+}
+
+// "YYYY-MM-DD" -> day; NO_DAY unless it is a real calendar date
+Day parseDate(string_view s) {
+    if (s.size() != 10 || s[4] != '-' || s[7] != '-') return NO_DAY;
+    int f[3] = {0, 0, 0};
+    const int starts[3] = {0, 5, 8}, lens[3] = {4, 2, 2};
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < lens[i]; ++k) {
+            char c = s[starts[i] + k];
+            if (c < '0' || c > '9') return NO_DAY;
+            f[i] = f[i] * 10 + (c - '0');
+        }
+    }
+    if (f[1] < 1 || f[1] > 12 || f[2] < 1) return NO_DAY;
+    Day day = daysFromCivil(f[0], f[1], f[2]);
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    return (m == f[1] && d == f[2]) ? day : NO_DAY; // rejects e.g. 2025-02-30
+}
+
+string formatDate(Day day) {
+    if (day == NO_DAY) return "";
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    char buf[16];
+    snprintf(buf, sizeof buf, "%04d-%02d-%02d", y, m, d);
+    return buf;
+}
+
+Day today() {
+    time_t now = time(nullptr);
+    tm local;
+    localtime_r(&now, &local);
+    return daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+// Outcome of a catalog or circulation operation
+enum class OpStatus { Ok, NotFound, Unavailable, NotOnLoan, BadDate, BadInput, Full };
+
+const char* statusText(OpStatus st) {
+    switch (st) {
+        case OpStatus::Ok: return "ok";
+        case OpStatus::NotFound: return "item not found";
+        case OpStatus::Unavailable: return "no copy available";
+        case OpStatus::NotOnLoan: return "not checked out";
+        case OpStatus::BadDate: return "invalid date";
+        case OpStatus::BadInput: return "invalid input";
+        case OpStatus::Full: return "library is full";
+    }
+    return "?";
+}
+
 // Abstract Base Class
 class LibraryItem {
+public:
+    struct ActiveLoan {
+        uint32_t id; // loan record in the library's Circulation
+        Day due;
+    };
+
 private:
-    string title;
-    string author;
-    string dueDate; // empty if not checked out
+    InlineString<47> title;  // in place up to the capacity, so most items
+    InlineString<31> author; // cost no heap blocks beyond their own
+    vector<ActiveLoan> loans; // one per copy on loan
+
+public:
+    LibraryItem(string_view t = "", string_view a = "") :
+        title(t), author(a) {}
 
 protected:
-    bool checkedOut;
+    // shared "Checked out: Yes (Due: ...)" line
+    void writeStatus(RecordWriter &w) const {
+        w.field("checked_out", "Checked out", isCheckedOut() ? "Yes" : "No");
+        string due = getDueDate();
+        if (loans.size() == 1) {
+            w.text(" (Due: ");
+            w.text(due);
+            w.text(")");
+        } else if (loans.size() > 1) {
+            w.text(" (");
+            w.text(to_string(loans.size()));
+            w.text(" copies, next due: ");
+            w.text(due);
+            w.text(")");
+        }
+        w.field("due", nullptr, due);
+    }
 
 public:
-    LibraryItem(const string &t = "", const string &a = "") :
-        title(t), author(a), dueDate(""), checkedOut(false) {}
 
-    // Encapsulation: getters/setters
-    string getTitle() const { return title; }
-    string getAuthor() const { return author; }
-    string getDueDate() const { return dueDate; }
+    // Encapsulation: getters/setters. The views stay valid until the field is
+    // set again or the item is deleted.
+    string_view getTitle() const { return title; }
+    string_view getAuthor() const { return author; }
+
+    void setTitle(string_view newTitle) { title = newTitle; }
+    void setAuthor(string_view newAuthor) { author = newAuthor; }
 
-    void setTitle(const string &newTitle) { title = newTitle; }
-    void setAuthor(const string &newAuthor) { author = newAuthor; }
-    void setDueDate(const string &newDueDate) { dueDate = newDueDate; }
+    bool isCheckedOut() const { return !loans.empty(); }
+    const vector<ActiveLoan>& activeLoans() const { return loans; }
 
-    bool isCheckedOut() const { return checkedOut; }
+    // earliest due date of the copies on loan; NO_DAY if none
+    Day nextDue() const {
+        Day due = NO_DAY;
+        for (const ActiveLoan& l : loans)
+            if (due == NO_DAY || l.due < due) due = l.due;
+        return due;
+    }
+    string getDueDate() const { return formatDate(nextDue()); }
+
+    void recordLoan(uint32_t id, Day due) { loans.push_back(ActiveLoan{id, due}); }
+
+    // the loan a return closes: the one due first; false if none
+    bool earliestLoan(ActiveLoan &out) const {
+        if (loans.empty()) return false;
+        out = loans[0];
+        for (const ActiveLoan& l : loans)
+            if (l.due < out.due) out = l;
+        return true;
+    }
+
+    void dropLoan(uint32_t id) {
+        for (size_t i = 0; i < loans.size(); ++i) {
+            if (loans[i].id != id) continue;
+            loans[i] = loans.back();
+            loans.pop_back();
+            return;
+        }
+    }
 
     // Pure virtual functions - must be overridden
-    virtual void checkOut() = 0;
-    virtual void returnItem() = 0;
-    virtual void displayDetails() const = 0;
+    // copies that can be checked out right now
+    virtual int copiesAvailable() const = 0;
+    // checkOut/returnItem update the item's own state only (the Library keeps
+    // the loan records) and print nothing; the print* functions give the
+    // interactive messages for a result
+    virtual OpStatus checkOut() = 0;
+    virtual OpStatus returnItem() = 0;
+    virtual void printCheckOut(OpStatus st, Day due) const = 0;
+    virtual void printReturn(OpStatus st) const = 0;
+    virtual void writeFields(RecordWriter &w) const = 0;
+
+    void displayDetails() const {
+        OutputBuffer out(cout, 1024);
+        RecordWriter w(out, OutputFormat::Table, "\n", "\n---------------------------\n");
+        w.begin();
+        writeFields(w);
+        w.end();
+    }
 
     virtual ~LibraryItem() = default;
 };
@@ -63,22 +317,22 @@ public:
 // Derived class: Book
 class Book : public LibraryItem {
 private:
-    string isbn;
+    InlineString<23> isbn;
     int copies; // number of copies available
 
 public:
-    Book(const string &t = "", const string &a = "", const string &isbn_ = "", int copies_ = 1)
+    Book(string_view t = "", string_view a = "", string_view isbn_ = "", int copies_ = 1)
         : LibraryItem(t, a), isbn(isbn_), copies(copies_) 
     {
         if (copies_ < 0) throw invalid_argument("Copies cannot be negative");
         if (!isbn_.empty() && !isValidISBN(isbn_)) throw invalid_argument("Invalid ISBN format");
     }
 
-    void setISBN(const string &newIsbn) {
+    void setISBN(string_view newIsbn) {
         if (!isValidISBN(newIsbn)) throw invalid_argument("Invalid ISBN format");
         isbn = newIsbn;
     }
-    string getISBN() const { return isbn; }
+    string_view getISBN() const { return isbn; }
 
     void setCopies(int c) {
         if (c < 0) throw invalid_argument("Copies cannot be negative");
@@ -87,54 +341,40 @@ public:
     int getCopies() const { return copies; }
 
     // Implement virtual functions
-    void checkOut() override {
-        if (copies <= 0) {
-            cout << "No copies available to check out for \"" << getTitle() << "\".\n";
-            return;
-        }
-        if (!isCheckedOut()) {
-            string duedate;
-            cout << "Enter due date (e.g., 2025-09-20) for the book \"" << getTitle() << "\": ";
-            getline(cin, duedate);
-            if (duedate.empty()) duedate = "N/A";
-            setDueDate(duedate);
-            checkedOut = true;
-            copies--;
-            cout << "Checked out book \"" << getTitle() << "\". Due date: " << getDueDate() << ". Remaining copies: " << copies << "\n";
-        } else {
-            // Even if the item object has checkedOut true, there might be more copies
-            // We'll allow checkout if copies > 0 (already handled), so reaching here means checkedOut==true and copies>0
-            string duedate;
-            cout << "Enter due date (e.g., 2025-09-20) for the book \"" << getTitle() << "\": ";
-            getline(cin, duedate);
-            if (duedate.empty()) duedate = "N/A";
-            setDueDate(duedate);
-            copies--;
-            cout << "Checked out another copy of \"" << getTitle() << "\". Due date: " << getDueDate() << ". Remaining copies: " << copies << "\n";
-        }
-    }
-
-    void returnItem() override {
-        if (getDueDate().empty() && !isCheckedOut() && copies == 0) {
-            // edge-case
-            cout << "This book does not appear to be checked out.\n";
-            return;
-        }
-        // For simplicity, returning increases copies and resets dueDate only if all copies become available.
+    int copiesAvailable() const override { return copies; }
+
+    OpStatus checkOut() override {
+        if (copies <= 0) return OpStatus::Unavailable;
+        copies--;
+        return OpStatus::Ok;
+    }
+
+    OpStatus returnItem() override {
+        if (!isCheckedOut()) return OpStatus::NotOnLoan;
         copies++;
-        setDueDate("");
-        checkedOut = (copies == 0);
-        cout << "Book \"" << getTitle() << "\" returned. Copies available: " << copies << "\n";
+        return OpStatus::Ok;
+    }
+
+    void printCheckOut(OpStatus st, Day due) const override {
+        if (st == OpStatus::Unavailable)
+            cout << "No copies available to check out for \"" << getTitle() << "\".\n";
+        else if (st == OpStatus::Ok)
+            cout << (activeLoans().size() > 1 ? "Checked out another copy of \"" : "Checked out book \"") << getTitle()
+                 << "\". Due date: " << formatDate(due) << ". Remaining copies: " << copies << "\n";
+    }
+
+    void printReturn(OpStatus st) const override {
+        if (st == OpStatus::NotOnLoan) cout << "This book does not appear to be checked out.\n";
+        else if (st == OpStatus::Ok) cout << "Book \"" << getTitle() << "\" returned. Copies available: " << copies << "\n";
     }
 
-    void displayDetails() const override {
-        cout << "Type: Book\n";
-        cout << "Title: " << getTitle() << "\n";
-        cout << "Author: " << getAuthor() << "\n";
-        cout << "ISBN: " << (isbn.empty() ? "N/A" : isbn) << "\n";
-        cout << "Copies available: " << copies << "\n";
-        cout << "Checked out: " << (checkedOut ? "Yes" : "No") << (getDueDate().empty() ? "" : " (Due: " + getDueDate() + ")") << "\n";
-        cout << "---------------------------\n";
+    void writeFields(RecordWriter &w) const override {
+        w.field("type", "Type", "Book");
+        w.field("title", "Title", getTitle());
+        w.field("author", "Author", getAuthor());
+        w.field("isbn", "ISBN", isbn.empty() && w.table() ? "N/A" : getISBN());
+        w.field("copies", "Copies available", copies);
+        writeStatus(w);
     }
 };
 
@@ -142,10 +382,10 @@ public:
 class DVD : public LibraryItem {
 private:
     int durationMinutes; // duration in minutes
-    string regionCode;
+    InlineString<15> regionCode;
 
 public:
-    DVD(const string &t = "", const string &a = "", int duration = 0, const string &region = "")
+    DVD(string_view t = "", string_view a = "", int duration = 0, string_view region = "")
         : LibraryItem(t, a), durationMinutes(duration), regionCode(region)
     {
         if (duration < 0) throw invalid_argument("Duration cannot be negative");
@@ -157,41 +397,34 @@ public:
     }
     int getDuration() const { return durationMinutes; }
 
-    void setRegion(const string &r) { regionCode = r; }
-    string getRegion() const { return regionCode; }
+    void setRegion(string_view r) { regionCode = r; }
+    string_view getRegion() const { return regionCode; }
 
-    void checkOut() override {
-        if (isCheckedOut()) {
-            cout << "This DVD \"" << getTitle() << "\" is already checked out. Due: " << (getDueDate().empty() ? "N/A" : getDueDate()) << "\n";
-            return;
-        }
-        string duedate;
-        cout << "Enter due date (e.g., 2025-09-20) for the DVD \"" << getTitle() << "\": ";
-        getline(cin, duedate);
-        if (duedate.empty()) duedate = "N/A";
-        setDueDate(duedate);
-        checkedOut = true;
-        cout << "Checked out DVD \"" << getTitle() << "\". Due date: " << getDueDate() << "\n";
+    int copiesAvailable() const override { return isCheckedOut() ? 0 : 1; }
+
+    OpStatus checkOut() override { return isCheckedOut() ? OpStatus::Unavailable : OpStatus::Ok; }
+
+    OpStatus returnItem() override { return isCheckedOut() ? OpStatus::Ok : OpStatus::NotOnLoan; }
+
+    void printCheckOut(OpStatus st, Day due) const override {
+        if (st == OpStatus::Unavailable)
+            cout << "This DVD \"" << getTitle() << "\" is already checked out. Due: " << getDueDate() << "\n";
+        else if (st == OpStatus::Ok)
+            cout << "Checked out DVD \"" << getTitle() << "\". Due date: " << formatDate(due) << "\n";
     }
 
-    void returnItem() override {
-        if (!isCheckedOut()) {
-            cout << "This DVD is not currently checked out.\n";
-            return;
-        }
-        setDueDate("");
-        checkedOut = false;
-        cout << "DVD \"" << getTitle() << "\" returned.\n";
+    void printReturn(OpStatus st) const override {
+        if (st == OpStatus::NotOnLoan) cout << "This DVD is not currently checked out.\n";
+        else if (st == OpStatus::Ok) cout << "DVD \"" << getTitle() << "\" returned.\n";
     }
 
-    void displayDetails() const override {
-        cout << "Type: DVD\n";
-        cout << "Title: " << getTitle() << "\n";
-        cout << "Director/Author: " << getAuthor() << "\n";
-        cout << "Duration: " << durationMinutes << " minutes\n";
-        cout << "Region: " << (regionCode.empty() ? "N/A" : regionCode) << "\n";
-        cout << "Checked out: " << (checkedOut ? "Yes" : "No") << (getDueDate().empty() ? "" : " (Due: " + getDueDate() + ")") << "\n";
-        cout << "---------------------------\n";
+    void writeFields(RecordWriter &w) const override {
+        w.field("type", "Type", "DVD");
+        w.field("title", "Title", getTitle());
+        w.field("author", "Director/Author", getAuthor());
+        w.field("duration", "Duration", durationMinutes, " minutes");
+        w.field("region", "Region", regionCode.empty() && w.table() ? "N/A" : getRegion());
+        writeStatus(w);
     }
 };
 
@@ -199,10 +432,10 @@ public:
 class Magazine : public LibraryItem {
 private:
     int issueNumber;
-    string month;
+    InlineString<15> month;
 
 public:
-    Magazine(const string &t = "", const string &a = "", int issue = 0, const string &m = "")
+    Magazine(string_view t = "", string_view a = "", int issue = 0, string_view m = "")
         : LibraryItem(t, a), issueNumber(issue), month(m)
     {
         if (issue < 0) throw invalid_argument("Issue number cannot be negative");
@@ -214,137 +447,792 @@ public:
     }
     int getIssueNumber() const { return issueNumber; }
 
-    void setMonth(const string &m) { month = m; }
-    string getMonth() const { return month; }
+    void setMonth(string_view m) { month = m; }
+    string_view getMonth() const { return month; }
 
-    void checkOut() override {
-        if (isCheckedOut()) {
-            cout << "This magazine \"" << getTitle() << "\" is already checked out. Due: " << (getDueDate().empty() ? "N/A" : getDueDate()) << "\n";
-            return;
+    int copiesAvailable() const override { return isCheckedOut() ? 0 : 1; }
+
+    OpStatus checkOut() override { return isCheckedOut() ? OpStatus::Unavailable : OpStatus::Ok; }
+
+    OpStatus returnItem() override { return isCheckedOut() ? OpStatus::Ok : OpStatus::NotOnLoan; }
+
+    void printCheckOut(OpStatus st, Day due) const override {
+        if (st == OpStatus::Unavailable)
+            cout << "This magazine \"" << getTitle() << "\" is already checked out. Due: " << getDueDate() << "\n";
+        else if (st == OpStatus::Ok)
+            cout << "Checked out magazine \"" << getTitle() << "\". Due date: " << formatDate(due) << "\n";
+    }
+
+    void printReturn(OpStatus st) const override {
+        if (st == OpStatus::NotOnLoan) cout << "This magazine is not currently checked out.\n";
+        else if (st == OpStatus::Ok) cout << "Magazine \"" << getTitle() << "\" returned.\n";
+    }
+
+    void writeFields(RecordWriter &w) const override {
+        w.field("type", "Type", "Magazine");
+        w.field("title", "Title", getTitle());
+        w.field("author", "Editor/Author", getAuthor());
+        w.field("issue", "Issue Number", issueNumber);
+        w.field("month", "Month", month.empty() && w.table() ? "N/A" : getMonth());
+        writeStatus(w);
+    }
+};
+
+/* Catalog index over titles and authors, with ASCII case folding.
+   - exact title / author lookup: an open-addressing table from the hash of
+     the folded text to a chain of item ids (per-item "next" links), so each
+     distinct title costs one 8-byte slot however many copies exist
+   - keyword search: an inverted index from folded word tokens to sorted
+     item-id posting lists; a query word ending in '*' matches as a prefix
+     through a sorted vocabulary
+   Items are indexed by their slot in the library. Titles and authors must not
+   change while an item is indexed. */
+
+// FNV-1a of the case-folded text
+uint64_t foldedHash(string_view s) {
+    uint64_t h = 1469598103934665603ull;
+    for (char c : s) h = (h ^ (unsigned char)tolower((unsigned char)c)) * 1099511628211ull;
+    return h;
+}
+
+bool equalsFolded(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    return true;
+}
+
+// calls f(token) for each run of letters/digits in text, folded to lower case
+template <class F>
+void forEachToken(string_view text, string& token, F f) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isalnum((unsigned char)text[i])) i++;
+        token.clear();
+        while (i < text.size() && isalnum((unsigned char)text[i])) token.push_back((char)tolower((unsigned char)text[i++]));
+        if (!token.empty()) f(token);
+    }
+}
+
+// hash -> chain of item ids; keys are the high 32 bits of the hash, so two
+// texts may share a chain and callers re-check the text
+class KeyChains {
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    struct Slot {
+        uint32_t tag;  // high hash bits | 1; 0 = empty
+        uint32_t head; // newest item with this key, NONE once all are removed
+    };
+    vector<Slot> slots;
+    size_t used;
+    vector<uint32_t> next; // by item id
+
+    static uint32_t tagOf(uint64_t h) { return (uint32_t)(h >> 32) | 1u; }
+    size_t home(uint32_t tag) const { return (size_t)((tag * 0x9E3779B97F4A7C15ull) >> 24) & (slots.size() - 1); }
+
+    const Slot* find(uint32_t tag) const {
+        if (slots.empty()) return nullptr;
+        for (size_t i = home(tag);; i = (i + 1) & (slots.size() - 1)) {
+            if (slots[i].tag == tag) return &slots[i];
+            if (slots[i].tag == 0) return nullptr;
         }
-        string duedate;
-        cout << "Enter due date (e.g., 2025-09-20) for the magazine \"" << getTitle() << "\": ";
-        getline(cin, duedate);
-        if (duedate.empty()) duedate = "N/A";
-        setDueDate(duedate);
-        checkedOut = true;
-        cout << "Checked out magazine \"" << getTitle() << "\". Due date: " << getDueDate() << "\n";
     }
 
-    void returnItem() override {
-        if (!isCheckedOut()) {
-            cout << "This magazine is not currently checked out.\n";
-            return;
+    Slot& place(const Slot& s) {
+        size_t i = home(s.tag);
+        while (slots[i].tag != 0) i = (i + 1) & (slots.size() - 1);
+        return slots[i] = s;
+    }
+
+    void rehash(size_t size) {
+        vector<Slot> old(size, Slot{0, NONE});
+        old.swap(slots);
+        for (const Slot& s : old) if (s.tag) place(s);
+    }
+
+public:
+    KeyChains() : used(0) {}
+
+    void reserve(size_t keys, size_t items) {
+        size_t size = 64;
+        while (size < keys * 2) size *= 2;
+        if (size > slots.size()) rehash(size);
+        next.reserve(items);
+    }
+
+    void insert(uint64_t h, uint32_t id) {
+        uint32_t tag = tagOf(h);
+        if (id >= next.size()) next.resize(id + 1, NONE);
+        Slot* s = const_cast<Slot*>(find(tag));
+        if (!s) {
+            if ((used + 1) * 2 > slots.size()) rehash(max<size_t>(64, slots.size() * 2));
+            s = &place(Slot{tag, NONE});
+            used++;
+        }
+        next[id] = s->head;
+        s->head = id;
+    }
+
+    void erase(uint64_t h, uint32_t id) {
+        Slot* s = const_cast<Slot*>(find(tagOf(h)));
+        if (!s) return;
+        for (uint32_t* link = &s->head; *link != NONE; link = &next[*link]) {
+            if (*link == id) {
+                *link = next[id];
+                next[id] = NONE;
+                return;
+            }
+        }
+    }
+
+    // ids renumbered to remap[id] (ascending, removed ids already erased);
+    // keys whose chains are empty are dropped
+    void renumber(const vector<uint32_t>& remap, size_t ids) {
+        vector<uint32_t> moved(ids, NONE);
+        vector<Slot> keys;
+        for (const Slot& s : slots) {
+            if (s.tag == 0 || s.head == NONE) continue;
+            Slot k{s.tag, remap[s.head]};
+            for (uint32_t id = s.head; next[id] != NONE; id = next[id]) moved[remap[id]] = remap[next[id]];
+            keys.push_back(k);
         }
-        setDueDate("");
-        checkedOut = false;
-        cout << "Magazine \"" << getTitle() << "\" returned.\n";
+        next.swap(moved);
+        size_t size = 64;
+        while (size < keys.size() * 2) size *= 2;
+        slots.assign(size, Slot{0, NONE});
+        for (const Slot& k : keys) place(k);
+        used = keys.size();
     }
 
-    void displayDetails() const override {
-        cout << "Type: Magazine\n";
-        cout << "Title: " << getTitle() << "\n";
-        cout << "Editor/Author: " << getAuthor() << "\n";
-        cout << "Issue Number: " << issueNumber << "\n";
-        cout << "Month: " << (month.empty() ? "N/A" : month) << "\n";
-        cout << "Checked out: " << (checkedOut ? "Yes" : "No") << (getDueDate().empty() ? "" : " (Due: " + getDueDate() + ")") << "\n";
-        cout << "---------------------------\n";
+    template <class F>
+    void forEach(uint64_t h, F f) const {
+        const Slot* s = find(tagOf(h));
+        for (uint32_t id = s ? s->head : NONE; id != NONE; id = next[id]) f(id);
     }
 };
 
-// Management of the library
-class Library {
+class CatalogIndex {
 private:
-    LibraryItem* items[MAX_ITEMS];
-    int count;
+    const vector<LibraryItem*>& items;
+    KeyChains titles, authors;
+    unordered_map<string, uint32_t> tokenIds;
+    vector<const string*> tokenText;      // by token id
+    vector<vector<uint32_t>> postings;    // by token id, ascending item ids
+    mutable vector<uint32_t> vocabulary;  // token ids in text order, for prefixes
+    mutable bool vocabularyStale;
+    string scratch;
+    vector<string> tokens;
+
+    // distinct tokens of an item's title and author
+    void itemTokens(const LibraryItem& it, vector<string>& out) {
+        size_t n = 0;
+        auto keep = [&](const string& t) {
+            if (n == out.size()) out.emplace_back();
+            out[n++] = t;
+        };
+        forEachToken(it.getTitle(), scratch, keep);
+        forEachToken(it.getAuthor(), scratch, keep);
+        out.resize(n);
+        sort(out.begin(), out.end());
+        out.erase(unique(out.begin(), out.end()), out.end());
+    }
+
+    const vector<uint32_t>* postingsFor(const string& token) const {
+        auto it = tokenIds.find(token);
+        return it == tokenIds.end() ? nullptr : &postings[it->second];
+    }
+
+    // token ids starting with prefix, as a range of the sorted vocabulary
+    pair<size_t, size_t> prefixRange(const string& prefix) const {
+        if (vocabularyStale) {
+            vocabulary.resize(tokenText.size());
+            for (uint32_t i = 0; i < vocabulary.size(); ++i) vocabulary[i] = i;
+            sort(vocabulary.begin(), vocabulary.end(),
+                 [this](uint32_t a, uint32_t b) { return *tokenText[a] < *tokenText[b]; });
+            vocabularyStale = false;
+        }
+        auto first = lower_bound(vocabulary.begin(), vocabulary.end(), prefix,
+                                 [this](uint32_t t, const string& p) { return *tokenText[t] < p; });
+        auto last = upper_bound(first, vocabulary.end(), prefix, [this](const string& p, uint32_t t) {
+            return tokenText[t]->compare(0, p.size(), p) > 0;
+        });
+        return {(size_t)(first - vocabulary.begin()), (size_t)(last - vocabulary.begin())};
+    }
+
+    // does text have a word starting with prefix (prefix is already folded)
+    static bool hasPrefix(string_view text, const string& prefix) {
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (!isalnum((unsigned char)text[i]) || (i > 0 && isalnum((unsigned char)text[i - 1]))) continue;
+            size_t k = 0;
+            while (k < prefix.size() && i + k < text.size() && tolower((unsigned char)text[i + k]) == prefix[k]) k++;
+            if (k == prefix.size()) return true;
+        }
+        return false;
+    }
 
 public:
-    Library() : count(0) {
-        for (int i = 0; i < MAX_ITEMS; ++i) items[i] = nullptr;
+    explicit CatalogIndex(const vector<LibraryItem*>& catalog) : items(catalog), vocabularyStale(false) {}
+
+    void reserve(size_t n) {
+        titles.reserve(n, n);
+        authors.reserve(n / 4, n);
     }
 
-    ~Library() {
-        // Release all allocated memory
-        for (int i = 0; i < MAX_ITEMS; ++i) {
-            if (items[i]) {
-                delete items[i];
-                items[i] = nullptr;
+    void add(uint32_t id) {
+        const LibraryItem& it = *items[id];
+        titles.insert(foldedHash(it.getTitle()), id);
+        authors.insert(foldedHash(it.getAuthor()), id);
+        itemTokens(it, tokens);
+        for (const string& t : tokens) {
+            auto found = tokenIds.find(t);
+            if (found == tokenIds.end()) {
+                found = tokenIds.emplace(t, (uint32_t)postings.size()).first;
+                tokenText.push_back(&found->first);
+                postings.emplace_back();
+                vocabularyStale = true;
             }
+            postings[found->second].push_back(id); // ids only grow, lists stay sorted
         }
     }
 
-    void addItem(LibraryItem* it) {
-        if (count >= MAX_ITEMS) {
-            cout << "Library is full. Cannot add more items.\n";
-            delete it;
-            return;
+    // call before the item is deleted; its postings stay behind (skipped
+    // because the catalog entry is null) until the next renumber()
+    void remove(uint32_t id) {
+        const LibraryItem& it = *items[id];
+        titles.erase(foldedHash(it.getTitle()), id);
+        authors.erase(foldedHash(it.getAuthor()), id);
+    }
+
+    // after the catalog drops its holes: id -> remap[id], NONE for removed
+    // items; words no live item has any more are forgotten
+    void renumber(const vector<uint32_t>& remap, size_t ids) {
+        titles.renumber(remap, ids);
+        authors.renumber(remap, ids);
+        vector<uint32_t> tokenRemap(postings.size(), 0xFFFFFFFFu);
+        uint32_t kept = 0;
+        for (uint32_t t = 0; t < postings.size(); ++t) {
+            vector<uint32_t>& p = postings[t];
+            size_t n = 0;
+            for (uint32_t id : p)
+                if (remap[id] != 0xFFFFFFFFu) p[n++] = remap[id];
+            p.resize(n);
+            if (n == 0) continue;
+            tokenRemap[t] = kept;
+            if (kept != t) {
+                postings[kept].swap(p);
+                tokenText[kept] = tokenText[t];
+            }
+            kept++;
         }
-        // find first null slot
-        for (int i = 0; i < MAX_ITEMS; ++i) {
-            if (items[i] == nullptr) {
-                items[i] = it;
-                count++;
-                cout << "Item added successfully.\n";
-                return;
+        postings.resize(kept);
+        tokenText.resize(kept);
+        for (auto it = tokenIds.begin(); it != tokenIds.end();) {
+            uint32_t t = tokenRemap[it->second];
+            if (t == 0xFFFFFFFFu) {
+                it = tokenIds.erase(it);
+            } else {
+                it->second = t;
+                ++it;
             }
         }
+        vocabularyStale = true;
+    }
+
+    // items whose title equals title ignoring case, ascending
+    void findTitle(string_view title, vector<uint32_t>& out) const {
+        out.clear();
+        titles.forEach(foldedHash(title), [&](uint32_t id) {
+            if (equalsFolded(items[id]->getTitle(), title)) out.push_back(id);
+        });
+        sort(out.begin(), out.end());
     }
 
-    void displayAll() const {
-        bool any = false;
-        for (int i = 0; i < MAX_ITEMS; ++i) {
-            if (items[i]) {
-                items[i]->displayDetails();
-                any = true;
+    void findAuthor(string_view author, vector<uint32_t>& out) const {
+        out.clear();
+        authors.forEach(foldedHash(author), [&](uint32_t id) {
+            if (equalsFolded(items[id]->getAuthor(), author)) out.push_back(id);
+        });
+        sort(out.begin(), out.end());
+    }
+
+    // items whose title or author contain every word of query (a word ending
+    // in '*' is a prefix); at most limit ids, ascending
+    void search(string_view query, size_t limit, vector<uint32_t>& out) {
+        out.clear();
+        struct Term {
+            string text;
+            bool prefix;
+            const vector<uint32_t>* list; // exact terms
+            size_t pos;                   // exact terms: cursor into list
+            size_t first, last;           // prefix terms: vocabulary range
+            size_t estimate;              // postings to read if this term drives
+        };
+        vector<Term> terms;
+        size_t rarest = SIZE_MAX; // smallest exact posting list
+        for (size_t i = 0; i < query.size();) {
+            while (i < query.size() && !isalnum((unsigned char)query[i])) i++;
+            Term t{string(), false, nullptr, 0, 0, 0, 0};
+            while (i < query.size() && isalnum((unsigned char)query[i]))
+                t.text.push_back((char)tolower((unsigned char)query[i++]));
+            if (t.text.empty()) continue;
+            t.prefix = i < query.size() && query[i] == '*';
+            if (t.prefix) {
+                pair<size_t, size_t> r = prefixRange(t.text);
+                t.first = r.first;
+                t.last = r.second;
+                t.estimate = r.second - r.first;
+            } else {
+                t.list = postingsFor(t.text);
+                t.estimate = t.list ? t.list->size() : 0;
+                rarest = min(rarest, t.estimate);
+            }
+            if (t.estimate == 0) return; // a word nothing contains
+            terms.push_back(std::move(t));
+        }
+        if (terms.empty() || limit == 0) return;
+        // a prefix term's cost is the total of its words' postings; counting
+        // stops once it is already larger than some exact term
+        for (Term& t : terms) {
+            if (!t.prefix) continue;
+            t.estimate = 0;
+            for (size_t v = t.first; v < t.last && t.estimate <= rarest; ++v)
+                t.estimate += postings[vocabulary[v]].size();
+        }
+
+        // the rarest term drives; exact terms are checked by advancing a cursor
+        // through their postings, prefix terms against the item's own words
+        size_t driver = 0;
+        for (size_t i = 1; i < terms.size(); ++i)
+            if (terms[i].estimate < terms[driver].estimate) driver = i;
+
+        auto accept = [&](uint32_t id) {
+            for (size_t i = 0; i < terms.size(); ++i) {
+                if (i == driver) continue;
+                Term& t = terms[i];
+                if (t.prefix) {
+                    if (!hasPrefix(items[id]->getTitle(), t.text) && !hasPrefix(items[id]->getAuthor(), t.text)) return false;
+                } else {
+                    const vector<uint32_t>& p = *t.list;
+                    t.pos = lower_bound(p.begin() + t.pos, p.end(), id) - p.begin();
+                    if (t.pos == p.size() || p[t.pos] != id) return false;
+                }
             }
+            return true;
+        };
+
+        const Term& d = terms[driver];
+        if (!d.prefix) {
+            for (uint32_t id : *d.list) {
+                if (items[id] && accept(id)) out.push_back(id);
+                if (out.size() == limit) return;
+            }
+            return;
+        }
+        // prefix driver: merge the postings of every matching word in id order
+        typedef pair<uint32_t, pair<uint32_t, uint32_t>> Head; // id, (token, position)
+        priority_queue<Head, vector<Head>, greater<Head>> heads;
+        for (size_t v = d.first; v < d.last; ++v) {
+            uint32_t tok = vocabulary[v];
+            if (!postings[tok].empty()) heads.push(Head(postings[tok][0], make_pair(tok, 0u)));
+        }
+        uint32_t last = 0xFFFFFFFFu;
+        while (!heads.empty()) {
+            Head h = heads.top();
+            heads.pop();
+            const vector<uint32_t>& p = postings[h.second.first];
+            if (h.second.second + 1 < p.size())
+                heads.push(Head(p[h.second.second + 1], make_pair(h.second.first, h.second.second + 1)));
+            if (h.first == last) continue;
+            last = h.first;
+            if (items[h.first] && accept(h.first)) out.push_back(h.first);
+            if (out.size() == limit) return;
+        }
+    }
+
+    size_t tokenCount() const { return tokenText.size(); }
+};
+
+// Management of the library
+// Stable reference to a catalog item: stays valid until that item is removed
+// and never refers to a later item that reuses the slot.
+struct ItemHandle {
+    uint32_t slot;
+    uint32_t generation;
+
+    static ItemHandle none() { return ItemHandle{0xFFFFFFFFu, 0}; }
+    bool valid() const { return slot != 0xFFFFFFFFu; }
+};
+
+/* Circulation: the active loans, one record per copy on loan, kept in a binary
+   min-heap on the due day. A record knows its heap position, so a return
+   removes it in O(log n). Loans overdue on a given day are found by walking
+   the heap from the root and not descending below any loan that is not yet
+   due, so a sweep visits the overdue loans plus at most one more node per
+   overdue loan, however many loans are out. */
+class Circulation {
+public:
+    struct Loan {
+        ItemHandle item;
+        Day due;
+        uint32_t heapPos; // NONE once returned (the id is then reused)
+    };
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    vector<Loan> loans;        // by loan id
+    vector<uint32_t> freeIds;
+    vector<uint32_t> heap;     // loan ids, min-heap on due
+    mutable vector<uint32_t> pending; // sweep stack of heap positions
+
+    void place(size_t pos, uint32_t id) {
+        heap[pos] = id;
+        loans[id].heapPos = (uint32_t)pos;
+    }
+
+    void siftUp(size_t pos) {
+        uint32_t id = heap[pos];
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (loans[heap[parent]].due <= loans[id].due) break;
+            place(pos, heap[parent]);
+            pos = parent;
         }
-        if (!any) cout << "Library catalog is empty.\n";
+        place(pos, id);
     }
 
-    LibraryItem* searchByTitle(const string &title) {
-        for (int i = 0; i < MAX_ITEMS; ++i) {
-            if (items[i] && items[i]->getTitle() == title) return items[i];
+    void siftDown(size_t pos) {
+        uint32_t id = heap[pos];
+        for (;;) {
+            size_t child = 2 * pos + 1;
+            if (child >= heap.size()) break;
+            if (child + 1 < heap.size() && loans[heap[child + 1]].due < loans[heap[child]].due) child++;
+            if (loans[id].due <= loans[heap[child]].due) break;
+            place(pos, heap[child]);
+            pos = child;
         }
-        return nullptr;
+        place(pos, id);
     }
 
-    void removeByTitle(const string &title) {
-        for (int i = 0; i < MAX_ITEMS; ++i) {
-            if (items[i] && items[i]->getTitle() == title) {
-                delete items[i];
-                items[i] = nullptr;
-                count--;
-                cout << "Item \"" << title << "\" removed from catalog.\n";
-                return;
-            }
+public:
+    void reserve(size_t n) {
+        loans.reserve(n);
+        heap.reserve(n);
+    }
+
+    size_t size() const { return heap.size(); }
+
+    const Loan& loan(uint32_t id) const { return loans[id]; }
+
+    uint32_t open(ItemHandle item, Day due) {
+        uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+            loans[id] = Loan{item, due, NONE};
+        } else {
+            id = (uint32_t)loans.size();
+            loans.push_back(Loan{item, due, NONE});
         }
-        cout << "Item not found.\n";
+        heap.push_back(id);
+        siftUp(heap.size() - 1);
+        return id;
     }
 
-    void checkOutItem(const string &title) {
-        LibraryItem* it = searchByTitle(title);
-        if (!it) {
-            cout << "Item not found.\n";
+    void close(uint32_t id) {
+        size_t pos = loans[id].heapPos;
+        if (pos == NONE) return;
+        loans[id].heapPos = NONE;
+        freeIds.push_back(id);
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (pos == heap.size()) return;
+        place(pos, last);
+        if (pos > 0 && loans[heap[(pos - 1) / 2]].due > loans[last].due) siftUp(pos);
+        else siftDown(pos);
+    }
+
+    // calls f(id, loan) for every active loan, in id order
+    template <class F>
+    void forEach(F f) const {
+        for (uint32_t id = 0; id < loans.size(); ++id)
+            if (loans[id].heapPos != NONE) f(id, loans[id]);
+    }
+
+    // calls f(id, loan) for every loan due before day, in no particular
+    // order; returns how many there were
+    template <class F>
+    size_t forEachOverdue(Day day, F f) const {
+        size_t found = 0;
+        pending.clear();
+        if (!heap.empty()) pending.push_back(0);
+        while (!pending.empty()) {
+            size_t pos = pending.back();
+            pending.pop_back();
+            const Loan& l = loans[heap[pos]];
+            if (l.due >= day) continue;
+            f(heap[pos], l);
+            found++;
+            if (2 * pos + 1 < heap.size()) pending.push_back(2 * pos + 1);
+            if (2 * pos + 2 < heap.size()) pending.push_back(2 * pos + 2);
+        }
+        return found;
+    }
+};
+
+/* Item storage: handle slots grow on demand and removed slots go on a free
+   list, so add and remove are O(1). Items sit in catalog order (which is also
+   their id in the index); removal leaves a hole there that compact() squeezes
+   out, which also happens automatically once holes outnumber live items, so
+   iteration stays proportional to the number of items. */
+class Library {
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    struct Slot {
+        uint32_t generation; // bumped when the item is removed
+        uint32_t link;       // live: catalog position; free: next free slot
+    };
+    vector<LibraryItem*> items; // catalog order; null for removed items
+    vector<uint32_t> owners;    // by catalog position: handle slot
+    vector<Slot> slots;
+    uint32_t freeHead;
+    size_t count;
+    size_t capacity;
+    CatalogIndex index;
+    Circulation circulation;
+    vector<uint32_t> hits;
+
+    ItemHandle handleAt(uint32_t pos) const { return ItemHandle{owners[pos], slots[owners[pos]].generation}; }
+
+    // catalog position of the item with this title: an exact match if there
+    // is one, otherwise the first match ignoring case; -1 if none
+    long findTitle(string_view title) {
+        index.findTitle(title, hits);
+        for (uint32_t id : hits)
+            if (items[id]->getTitle() == title) return id;
+        return hits.empty() ? -1 : (long)hits[0];
+    }
+
+    void release(uint32_t pos) {
+        for (const LibraryItem::ActiveLoan& l : items[pos]->activeLoans()) circulation.close(l.id);
+        index.remove(pos);
+        delete items[pos];
+        items[pos] = nullptr;
+        uint32_t slot = owners[pos];
+        slots[slot].generation++;
+        slots[slot].link = freeHead;
+        freeHead = slot;
+        count--;
+        size_t holes = items.size() - count;
+        if (holes > 64 && holes > count) compact();
+    }
+
+public:
+    explicit Library(size_t maxItems = SIZE_MAX)
+        : freeHead(NONE), count(0), capacity(maxItems), index(items) {}
+
+    ~Library() {
+        // Release all allocated memory
+        for (LibraryItem* it : items) delete it;
+    }
+
+    Library(const Library&) = delete;
+    Library& operator=(const Library&) = delete;
+
+    void reserve(size_t n) {
+        items.reserve(n);
+        owners.reserve(n);
+        slots.reserve(n);
+        index.reserve(n);
+    }
+
+    size_t size() const { return count; }
+
+    // takes ownership on success; none() if the library is full
+    ItemHandle insert(LibraryItem* it) {
+        if (count >= capacity) return ItemHandle::none();
+        if (items.size() >= NONE - 1) compact();
+        if (items.size() >= NONE - 1) return ItemHandle::none();
+        uint32_t slot = freeHead;
+        if (slot != NONE) freeHead = slots[slot].link;
+        else {
+            slot = (uint32_t)slots.size();
+            slots.push_back(Slot{0, NONE});
+        }
+        uint32_t pos = (uint32_t)items.size();
+        slots[slot].link = pos;
+        items.push_back(it);
+        owners.push_back(slot);
+        count++;
+        index.add(pos);
+        return ItemHandle{slot, slots[slot].generation};
+    }
+
+    // null if the handle's item has been removed
+    LibraryItem* get(ItemHandle h) const {
+        if (h.slot >= slots.size() || slots[h.slot].generation != h.generation) return nullptr;
+        return items[slots[h.slot].link];
+    }
+
+    bool remove(ItemHandle h) {
+        if (!get(h)) return false;
+        release(slots[h.slot].link);
+        return true;
+    }
+
+    // drops the holes left by removals, keeping catalog order
+    void compact() {
+        if (count == items.size()) return;
+        vector<uint32_t> remap(items.size(), NONE);
+        size_t n = 0;
+        for (size_t pos = 0; pos < items.size(); ++pos) {
+            if (!items[pos]) continue;
+            remap[pos] = (uint32_t)n;
+            items[n] = items[pos];
+            owners[n] = owners[pos];
+            slots[owners[n]].link = (uint32_t)n;
+            n++;
+        }
+        items.resize(n);
+        owners.resize(n);
+        index.renumber(remap, n);
+    }
+
+    // calls f(item) for every item in catalog order
+    template <class F>
+    void forEach(F f) const {
+        for (const LibraryItem* it : items)
+            if (it) f(*it);
+    }
+
+    void addItem(LibraryItem* it) {
+        if (!insert(it).valid()) {
+            cout << "Library is full. Cannot add more items.\n";
+            delete it;
             return;
         }
-        try {
-            it->checkOut();
-        } catch (exception &e) {
-            cout << "Error while checking out: " << e.what() << "\n";
+        cout << "Item added successfully.\n";
+    }
+
+    void displayAll(OutputFormat fmt = OutputFormat::Table) const {
+        static const char* const columns[] = {"type", "title", "author", "isbn", "copies", "duration",
+                                              "region", "issue", "month", "checked_out", "due"};
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, "\n", "\n---------------------------\n", columns, 11);
+        w.header();
+        forEach([&](const LibraryItem& it) {
+            w.begin();
+            it.writeFields(w);
+            w.end();
+        });
+        if (count == 0 && w.table()) out << "Library catalog is empty.\n";
+    }
+
+    LibraryItem* searchByTitle(string_view title) {
+        long id = findTitle(title);
+        return id < 0 ? nullptr : items[id];
+    }
+
+    // all items by this author (ignoring case), in catalog order
+    vector<LibraryItem*> searchByAuthor(string_view author) {
+        index.findAuthor(author, hits);
+        vector<LibraryItem*> found;
+        for (uint32_t id : hits) found.push_back(items[id]);
+        return found;
+    }
+
+    // items whose title or author contain every word of query; "word*"
+    // matches any word starting with "word"
+    vector<LibraryItem*> search(string_view query, size_t limit = 50) {
+        index.search(query, limit, hits);
+        vector<LibraryItem*> found;
+        for (uint32_t id : hits) found.push_back(items[id]);
+        return found;
+    }
+
+    void removeByTitle(string_view title) {
+        long id = findTitle(title);
+        if (id < 0) {
+            cout << "Item not found.\n";
+            return;
         }
+        string removed(items[id]->getTitle());
+        release((uint32_t)id);
+        cout << "Item \"" << removed << "\" removed from catalog.\n";
+    }
+
+    // one copy of the item with this title, due on the given day
+    OpStatus checkOut(string_view title, Day due) {
+        long id = findTitle(title);
+        if (id < 0) return OpStatus::NotFound;
+        if (due == NO_DAY) return OpStatus::BadDate;
+        LibraryItem* it = items[id];
+        OpStatus st = it->checkOut();
+        if (st == OpStatus::Ok) it->recordLoan(circulation.open(handleAt((uint32_t)id), due), due);
+        return st;
+    }
+
+    // returns the copy that is due first
+    OpStatus returnCopy(string_view title) {
+        long id = findTitle(title);
+        if (id < 0) return OpStatus::NotFound;
+        LibraryItem* it = items[id];
+        LibraryItem::ActiveLoan loan = {0, NO_DAY};
+        if (!it->earliestLoan(loan)) return OpStatus::NotOnLoan;
+        OpStatus st = it->returnItem();
+        if (st != OpStatus::Ok) return st;
+        it->dropLoan(loan.id);
+        circulation.close(loan.id);
+        return st;
     }
 
-    void returnItem(const string &title) {
+    OpStatus removeTitle(string_view title) {
+        long id = findTitle(title);
+        if (id < 0) return OpStatus::NotFound;
+        release((uint32_t)id);
+        return OpStatus::Ok;
+    }
+
+    // checkOut/returnCopy with the interactive messages
+    void checkOutItem(string_view title, Day due) {
+        OpStatus st = checkOut(title, due);
+        if (st == OpStatus::NotFound) cout << "Item not found.\n";
+        else if (st == OpStatus::BadDate) cout << "Invalid date. Nothing was checked out.\n";
+        else searchByTitle(title)->printCheckOut(st, due);
+    }
+
+    void returnItem(string_view title) {
         LibraryItem* it = searchByTitle(title);
         if (!it) {
             cout << "Item not found.\n";
             return;
         }
-        try {
-            it->returnItem();
-        } catch (exception &e) {
-            cout << "Error while returning item: " << e.what() << "\n";
+        it->printReturn(returnCopy(title));
+    }
+
+    size_t loanCount() const { return circulation.size(); }
+
+    // copies on loan that were due before day, most overdue first
+    void listOverdue(Day day, OutputFormat fmt = OutputFormat::Table) const {
+        static const char* const columns[] = {"title", "author", "due", "days_overdue"};
+        vector<pair<Day, ItemHandle>> overdue;
+        circulation.forEachOverdue(day, [&](uint32_t, const Circulation::Loan& l) {
+            overdue.push_back(make_pair(l.due, l.item));
+        });
+        sort(overdue.begin(), overdue.end(),
+             [](const pair<Day, ItemHandle>& a, const pair<Day, ItemHandle>& b) { return a.first < b.first; });
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, ", ", "\n", columns, 4);
+        w.header();
+        for (const pair<Day, ItemHandle>& o : overdue) {
+            const LibraryItem* it = get(o.second);
+            w.begin();
+            w.field("title", "Title", it->getTitle());
+            w.field("author", "Author", it->getAuthor());
+            w.field("due", "Due", formatDate(o.first));
+            w.field("days_overdue", "Days overdue", (int)(day - o.first));
+            w.end();
         }
+        if (overdue.empty() && w.table()) out << "No overdue loans as of " << formatDate(day) << ".\n";
     }
 };
 
@@ -419,6 +1307,15 @@ void addMagazineInteractive(Library &lib) {
     }
 }
 
+void showResults(const vector<LibraryItem*> &found) {
+    if (found.empty()) {
+        cout << "No matching items.\n";
+        return;
+    }
+    cout << found.size() << " item(s) found:\n";
+    for (LibraryItem* it : found) it->displayDetails();
+}
+
 void showMenu() {
     cout << "\n--- Library Menu ---\n";
     cout << "1. Add Book\n";
@@ -430,10 +1327,558 @@ void showMenu() {
     cout << "7. Return Item\n";
     cout << "8. Remove Item by Title\n";
     cout << "9. Exit\n";
+    cout << "10. Search by Author\n";
+    cout << "11. Keyword Search (word* = prefix)\n";
+    cout << "12. Overdue Loans\n";
     cout << "Choice: ";
 }
 
-int main() {
+static double secondsSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+/* Batch mode: libraryManagement --batch <file|->
+   Applies one command per line, fields separated by '|':
+     add book <title>|<author>|<isbn>|<copies>
+     add dvd <title>|<director>|<minutes>|<region>
+     add magazine <title>|<editor>|<issue>|<month>
+     checkout <title>[|<YYYY-MM-DD>]      (default: LOAN_DAYS from today)
+     return <title>
+     remove <title>
+   Blank lines and lines starting with '#' are skipped. Failed operations are
+   reported on stderr with their line number; a summary with per-operation
+   latencies goes to stdout. Exit status: 0 if every operation succeeded, 2
+   if some were refused, 1 on unreadable input or malformed lines. */
+
+static string_view trimmed(string_view s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isspace((unsigned char)s[b])) b++;
+    while (e > b && isspace((unsigned char)s[e - 1])) e--;
+    return s.substr(b, e - b);
+}
+
+// the '|'-separated fields of a line, as views into it; no command takes
+// more than MAX, so only the count of any further fields is kept
+struct Fields {
+    static const size_t MAX = 4;
+    string_view at[MAX];
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    string_view operator[](size_t i) const { return at[i]; }
+};
+
+static Fields splitFields(string_view s) {
+    Fields f;
+    size_t start = 0;
+    for (size_t i = 0; i <= s.size(); ++i) {
+        if (i < s.size() && s[i] != '|') continue;
+        if (f.count < Fields::MAX) f.at[f.count] = trimmed(s.substr(start, i - start));
+        f.count++;
+        start = i + 1;
+    }
+    return f;
+}
+
+static bool parseCount(string_view s, int& out) {
+    const char* end = s.data() + s.size();
+    auto r = from_chars(s.data(), end, out);
+    return r.ec == errc() && r.ptr == end;
+}
+
+static OpStatus addFromFields(Library& lib, string_view kind, const Fields& f) {
+    if (f.size() != 4) return OpStatus::BadInput;
+    int n;
+    LibraryItem* it = nullptr;
+    try {
+        if (kind == "book" && parseCount(f[3], n)) it = new Book(f[0], f[1], f[2], n);
+        else if (kind == "dvd" && parseCount(f[2], n)) it = new DVD(f[0], f[1], n, f[3]);
+        else if (kind == "magazine" && parseCount(f[2], n)) it = new Magazine(f[0], f[1], n, f[3]);
+    } catch (exception&) {
+        return OpStatus::BadInput;
+    }
+    if (!it) return OpStatus::BadInput;
+    if (!lib.insert(it).valid()) {
+        delete it;
+        return OpStatus::Full;
+    }
+    return OpStatus::Ok;
+}
+
+// count, mean and percentiles of one operation's latencies (nanoseconds)
+static void latencySummary(const char* name, vector<double>& ns) {
+    if (ns.empty()) return;
+    sort(ns.begin(), ns.end());
+    double total = 0;
+    for (double v : ns) total += v;
+    cout << "  " << name << ": " << ns.size() << " ops  mean " << (long)(total / ns.size())
+         << " ns  p50 " << (long)ns[ns.size() / 2] << " ns  p99 " << (long)ns[ns.size() * 99 / 100]
+         << " ns  max " << (long)ns.back() << " ns\n";
+}
+
+static int runBatch(Library& lib, istream& in) {
+    enum { ADD, CHECKOUT, RETURN, REMOVE, KINDS };
+    static const char* const names[KINDS] = {"add", "checkout", "return", "remove"};
+    vector<double> latency[KINDS];
+    size_t statusCount[(int)OpStatus::Full + 1] = {};
+    size_t malformed = 0, lineNo = 0;
+    const Day defaultDue = today() + LOAN_DAYS;
+
+    string line;
+    auto t0 = chrono::steady_clock::now();
+    while (getline(in, line)) {
+        lineNo++;
+        string_view l(line);
+        size_t b = 0;
+        while (b < l.size() && isspace((unsigned char)l[b])) b++;
+        if (b == l.size() || l[b] == '#') continue;
+        size_t sp = l.find(' ', b);
+        string_view cmd = l.substr(b, sp == string_view::npos ? string_view::npos : sp - b);
+        string_view rest = sp == string_view::npos ? string_view() : l.substr(sp + 1);
+
+        int kind = KINDS;
+        OpStatus st = OpStatus::BadInput;
+        auto start = chrono::steady_clock::now();
+        if (cmd == "add") {
+            kind = ADD;
+            size_t k = rest.find(' ');
+            string_view type = trimmed(rest.substr(0, k));
+            if (k != string_view::npos) st = addFromFields(lib, type, splitFields(rest.substr(k + 1)));
+        } else if (cmd == "checkout") {
+            kind = CHECKOUT;
+            Fields f = splitFields(rest);
+            if (f.size() == 1) st = lib.checkOut(f[0], defaultDue);
+            else if (f.size() == 2) st = lib.checkOut(f[0], parseDate(f[1]));
+        } else if (cmd == "return") {
+            kind = RETURN;
+            st = lib.returnCopy(trimmed(rest));
+        } else if (cmd == "remove") {
+            kind = REMOVE;
+            st = lib.removeTitle(trimmed(rest));
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+        if (kind == KINDS) {
+            cerr << "line " << lineNo << ": unknown command \"" << cmd << "\"\n";
+            malformed++;
+            continue;
+        }
+        latency[kind].push_back(ns);
+        statusCount[(int)st]++;
+        if (st != OpStatus::Ok) cerr << "line " << lineNo << ": " << names[kind] << ": " << statusText(st) << "\n";
+    }
+    double sec = secondsSince(t0);
+
+    size_t ops = 0;
+    for (int k = 0; k < KINDS; ++k) ops += latency[k].size();
+    cout << ops << " operations in " << sec << " s (" << (long)(ops / (sec > 0 ? sec : 1)) << " ops/s)\n";
+    for (int s = 0; s <= (int)OpStatus::Full; ++s)
+        if (statusCount[s]) cout << "  " << statusText((OpStatus)s) << ": " << statusCount[s] << "\n";
+    if (malformed) cout << "  malformed lines: " << malformed << "\n";
+    for (int k = 0; k < KINDS; ++k) latencySummary(names[k], latency[k]);
+    cout << "items: " << lib.size() << "  copies on loan: " << lib.loanCount() << "\n";
+
+    if (malformed) return 1;
+    return statusCount[(int)OpStatus::Ok] == ops ? 0 : 2;
+}
+
+// Benchmarks (run with --bench <name>)
+
+// synthetic words: 2-4 syllables, so prefixes and shared words are realistic
+static string syntheticWord(uint64_t x) {
+    static const char* const syllables[] = {"ka", "lo", "mi", "ren", "sa", "tor", "vel", "an", "dri", "so",
+                                            "ma", "qui", "ber", "lin", "ost", "ha", "ne", "pe", "gar", "tu"};
+    string w;
+    int n = 2 + (int)(x % 3);
+    x /= 3;
+    for (int i = 0; i < n; ++i, x /= 20) w += syllables[x % 20];
+    return w;
+}
+
+// per-query latency of f(i) for i in [0, n): prints p50/p99 in microseconds
+template <class F>
+static void latencyReport(const char* name, size_t n, F f) {
+    vector<double> us(n);
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto t0 = chrono::steady_clock::now();
+        hits += f(i);
+        us[i] = secondsSince(t0) * 1e6;
+    }
+    sort(us.begin(), us.end());
+    cout << "  " << name << ": p50 " << us[n / 2] << " us  p99 " << us[n * 99 / 100]
+         << " us  (" << hits << " results)\n";
+}
+
+// title/author lookup and keyword search over a synthetic catalog of n books
+static void benchIndex(size_t n) {
+    mt19937_64 rng(42);
+    const size_t vocabulary = 50000, authors = n / 20 + 1;
+    vector<string> words(vocabulary), names(authors);
+    for (size_t i = 0; i < vocabulary; ++i) words[i] = syntheticWord(rng());
+    for (size_t i = 0; i < authors; ++i) {
+        names[i] = syntheticWord(rng());
+        names[i][0] = (char)toupper((unsigned char)names[i][0]);
+        names[i] += " " + syntheticWord(rng());
+    }
+
+    Library lib;
+    lib.reserve(n);
+    vector<string> titles;
+    titles.reserve(1000);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        // skewed word choice: a few very common words, a long tail of rare ones
+        string title = "The";
+        for (int k = 0; k < 3; ++k) {
+            uint64_t r = rng();
+            title += " " + words[(r >> 32) % 4 ? r % vocabulary : r % 64];
+        }
+        title += " " + to_string(i);
+        if (titles.size() < 1000) titles.push_back(title);
+        lib.insert(new Book(title, names[rng() % authors], "", 1));
+    }
+    double buildSec = secondsSince(t0);
+    cout << "items=" << n << "  build: " << (long)(n / buildSec) << " items/s\n";
+
+    const size_t queries = 100000;
+    vector<string> probes(queries);
+    auto pick = [&]() { return (size_t)(rng() % titles.size()); };
+
+    for (size_t i = 0; i < queries; ++i) {
+        probes[i] = titles[pick()];
+        for (char& c : probes[i]) c = (char)toupper((unsigned char)c); // case-folded match
+    }
+    latencyReport("title (exact, any case)", queries, [&](size_t i) { return lib.searchByTitle(probes[i]) ? 1 : 0; });
+
+    for (size_t i = 0; i < queries; ++i) probes[i] = names[rng() % authors];
+    latencyReport("author (exact)", queries, [&](size_t i) { return lib.searchByAuthor(probes[i]).size(); });
+
+    for (size_t i = 0; i < queries; ++i) probes[i] = words[rng() % vocabulary] + " " + words[rng() % vocabulary];
+    latencyReport("two keywords", queries, [&](size_t i) { return lib.search(probes[i]).size(); });
+
+    for (size_t i = 0; i < queries; ++i) probes[i] = words[rng() % vocabulary].substr(0, 4) + "*";
+    latencyReport("prefix (4 chars)", queries, [&](size_t i) { return lib.search(probes[i]).size(); });
+
+    for (size_t i = 0; i < queries; ++i) {
+        const string& a = names[rng() % authors];
+        probes[i] = a.substr(0, a.find(' ')) + " " + words[rng() % vocabulary].substr(0, 3) + "*";
+    }
+    latencyReport("author word + prefix", queries, [&](size_t i) { return lib.search(probes[i]).size(); });
+}
+
+// interleaved add/remove at n items: free-list slots vs scanning a pointer
+// array for the first empty slot (the old fixed-array layout)
+static void benchChurn(size_t n) {
+    mt19937_64 rng(7);
+    auto makeBook = [](size_t i) {
+        return new Book("Item " + to_string(i) + " " + syntheticWord(i * 2654435761u), "Author " + to_string(i % 5000), "", 1);
+    };
+
+    Library lib;
+    lib.reserve(n);
+    vector<ItemHandle> handles(n);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) handles[i] = lib.insert(makeBook(i));
+    double loadSec = secondsSince(t0);
+
+    const size_t ops = n;
+    size_t stale = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) {
+        size_t k = rng() % n;
+        ItemHandle old = handles[k];
+        lib.remove(old);
+        handles[k] = lib.insert(makeBook(n + i));
+        if (lib.get(old)) stale++; // the reused slot must not answer to the old handle
+    }
+    double churnSec = secondsSince(t0);
+
+    long copies = 0;
+    t0 = chrono::steady_clock::now();
+    lib.forEach([&](const LibraryItem& it) { copies += static_cast<const Book&>(it).getCopies(); });
+    double scanSec = secondsSince(t0);
+
+    // old layout: same churn against a plain pointer array, no index
+    vector<LibraryItem*> slots(n);
+    for (size_t i = 0; i < n; ++i) slots[i] = makeBook(i);
+    const size_t scanOps = min<size_t>(ops, 2000);
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < scanOps; ++i) {
+        size_t k = rng() % n;
+        delete slots[k];
+        slots[k] = nullptr;
+        size_t free = 0;
+        while (slots[free]) free++;
+        slots[free] = makeBook(n + i);
+    }
+    double oldSec = secondsSince(t0);
+    for (LibraryItem* it : slots) delete it;
+
+    cout << "items=" << n << "  load: " << (long)(n / loadSec) << " items/s"
+         << "  churn (remove+add, indexed): " << (long)(2 * ops / churnSec) << " ops/s"
+         << "  scan: " << scanSec * 1e9 / n << " ns/item (" << copies << " copies)"
+         << "  stale handles: " << stale << "\n"
+         << "  first-empty-slot scan, unindexed: " << (long)(2 * scanOps / oldSec) << " ops/s\n";
+}
+
+// the digit-count-only check isValidISBN() used to do, for comparison
+static bool isbnLengthOnly(const string &isbn) {
+    string digits;
+    for (char c : isbn) {
+        if (isdigit((unsigned char)c)) digits.push_back(c);
+        else if (c == '-') continue;
+        else return false;
+    }
+    return (digits.length() == 10 || digits.length() == 13);
+}
+
+// validation of a publisher feed held in one buffer, one ISBN per line: plain
+// and hyphenated ISBN-13s, ISBN-10s (some ending in X), about 5% with a
+// corrupted digit
+static void benchIsbn(size_t n) {
+    mt19937_64 rng(11);
+    string feed;
+    vector<size_t> starts(n + 1);
+    string s;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t r = rng();
+        s.clear();
+        if (r % 3 == 0) { // ISBN-10
+            int sum = 0;
+            for (int k = 0; k < 9; ++k) {
+                int d = (int)(rng() % 10);
+                s.push_back((char)('0' + d));
+                sum += (10 - k) * d;
+            }
+            int check = (11 - sum % 11) % 11;
+            s.push_back(check == 10 ? 'X' : (char)('0' + check));
+            if (r & 8) s = s.substr(0, 1) + "-" + s.substr(1, 3) + "-" + s.substr(4, 5) + "-" + s.substr(9);
+        } else {
+            s = r % 3 == 1 ? "978" : "979";
+            int sum = r % 3 == 1 ? 38 : 39;
+            for (int k = 3; k < 12; ++k) {
+                int d = (int)(rng() % 10);
+                s.push_back((char)('0' + d));
+                sum += (k % 2 ? 3 : 1) * d;
+            }
+            s.push_back((char)('0' + (10 - sum % 10) % 10));
+            if (r & 8) s = s.substr(0, 3) + "-" + s.substr(3, 1) + "-" + s.substr(4, 3) + "-" + s.substr(7, 5) + "-" + s.substr(12);
+        }
+        if (r % 20 == 7) { // corrupt one digit
+            size_t k = s.find_first_of("0123456789", (r >> 8) % s.size());
+            if (k != string::npos) s[k] = s[k] == '9' ? '0' : (char)(s[k] + 1);
+        }
+        starts[i] = feed.size();
+        feed += s;
+        feed += '\n';
+    }
+    starts[n] = feed.size();
+    vector<string_view> views(n);
+    for (size_t i = 0; i < n; ++i) views[i] = string_view(feed.data() + starts[i], starts[i + 1] - starts[i] - 1);
+    vector<uint64_t> keys(n);
+
+    auto t0 = chrono::steady_clock::now();
+    size_t oldValid = 0;
+    for (size_t i = 0; i < n; ++i) oldValid += isbnLengthOnly(string(views[i]));
+    double oldSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t scalarValid = 0;
+    uint64_t scalarSum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t k = isbnKey(views[i]);
+        scalarValid += k != 0;
+        scalarSum += k;
+    }
+    double scalarSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t batchValid = isbnKeys(views.data(), n, keys.data());
+    double batchSec = secondsSince(t0);
+
+    size_t mismatches = 0;
+    uint64_t batchSum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        batchSum += keys[i];
+        if (i % 16 == 0 && keys[i] != isbnKey(views[i])) mismatches++;
+    }
+
+    cout << "isbns=" << n << "\n"
+         << "  length-only check: " << (long)(n / oldSec) << " /s  (" << oldValid << " accepted)\n"
+         << "  isbnKey (scalar):  " << (long)(n / scalarSec) << " /s  (" << scalarValid << " valid)\n"
+         << "  isbnKeys (batch):  " << (long)(n / batchSec) << " /s  (" << batchValid << " valid"
+         << (batchSum == scalarSum && mismatches == 0 ? ", same keys" : ", KEYS DIFFER") << ")\n";
+}
+
+// daily circulation over n active loans: most copies come back on their due
+// day, the rest stay out and pile up as overdue; each day's overdue sweep is
+// timed against a scan of every loan record
+static void benchOverdue(size_t n) {
+    mt19937_64 rng(3);
+    const Day start = daysFromCivil(2025, 1, 1);
+    const int days = 10;
+    Circulation circ;
+    circ.reserve(n);
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        circ.open(ItemHandle{(uint32_t)(i % 1000000), 0}, start + 1 + (Day)(rng() % (2 * LOAN_DAYS)));
+    double openSec = secondsSince(t0);
+    cout << "loans=" << n << "  open: " << (long)(n / openSec) << " loans/s\n";
+
+    vector<uint32_t> dueToday;
+    double sweepSec = 0, scanSec = 0, turnoverSec = 0;
+    size_t swept = 0, turnover = 0;
+    for (int k = 1; k <= days; ++k) {
+        Day day = start + k;
+        // returns: 95% of the copies due today come back, each replaced by a new loan
+        t0 = chrono::steady_clock::now();
+        dueToday.clear();
+        circ.forEachOverdue(day + 1, [&](uint32_t id, const Circulation::Loan& l) {
+            if (l.due == day && rng() % 20 != 0) dueToday.push_back(id);
+        });
+        for (uint32_t id : dueToday) {
+            ItemHandle item = circ.loan(id).item;
+            circ.close(id);
+            circ.open(item, day + LOAN_DAYS + (Day)(rng() % LOAN_DAYS));
+        }
+        turnoverSec += secondsSince(t0);
+        turnover += dueToday.size();
+
+        t0 = chrono::steady_clock::now();
+        size_t overdue = circ.forEachOverdue(day, [&](uint32_t, const Circulation::Loan&) {});
+        double sweep = secondsSince(t0);
+        t0 = chrono::steady_clock::now();
+        size_t scanned = 0;
+        circ.forEach([&](uint32_t, const Circulation::Loan& l) { scanned += l.due < day; });
+        double scan = secondsSince(t0);
+        sweepSec += sweep;
+        scanSec += scan;
+        swept += overdue;
+        cout << "  " << formatDate(day) << ": " << overdue << " overdue"
+             << "  heap sweep " << sweep * 1e3 << " ms"
+             << "  full scan " << scan * 1e3 << " ms" << (scanned == overdue ? "" : "  (MISMATCH)") << "\n";
+    }
+    cout << "  return+checkout: " << (long)(2 * turnover / turnoverSec) << " ops/s"
+         << "  sweep: " << (swept ? sweepSec * 1e9 / swept : 0) << " ns per overdue loan"
+         << "  full scan: " << scanSec * 1e3 / days << " ms/day\n";
+}
+
+// heap allocations per item while adding batch lines, scanning through the
+// getters, looking titles up and dumping the catalog. Most titles and author
+// names are longer than std::string keeps in place.
+// Needs a build with -DCOUNT_ALLOCATIONS (see allocationCounter.h).
+static void benchAlloc(size_t n) {
+    mt19937_64 rng(24);
+    vector<string> words(5000), lines(n), probes(n);
+    for (string& w : words) w = syntheticWord(rng());
+    for (size_t i = 0; i < n; ++i) {
+        string title = "The " + words[rng() % 5000] + " " + words[rng() % 5000] + " " + to_string(i);
+        string person = words[rng() % 5000] + " " + words[rng() % 5000];
+        person[0] = (char)toupper((unsigned char)person[0]);
+        switch (i % 3) {
+            case 0: lines[i] = "book " + title + "|" + person + "||" + to_string(1 + i % 4); break;
+            case 1: lines[i] = "dvd " + title + "|" + person + "|" + to_string(90 + i % 60) + "|2"; break;
+            default: lines[i] = "magazine " + title + "|" + person + "|" + to_string(i % 12) + "|September"; break;
+        }
+        probes[i] = title;
+    }
+    shuffle(probes.begin(), probes.end(), rng);
+
+    cout << "items=" << n << "\n";
+    auto measure = [n](const char* label, auto body) {
+        uint64_t before = allocationCount();
+        auto t0 = chrono::steady_clock::now();
+        body();
+        double sec = secondsSince(t0);
+        uint64_t allocs = allocationCount() - before;
+        cout << "  " << label << ":" << string(14 - strlen(label), ' ') << allocs << " allocations ("
+             << (double)allocs / n << " per item)  " << sec * 1e3 << " ms\n";
+    };
+
+    Library lib;
+    lib.reserve(n);
+    size_t ok = 0;
+    measure("add", [&] {
+        for (const string& line : lines) {
+            size_t sp = line.find(' ');
+            ok += addFromFields(lib, string_view(line).substr(0, sp), splitFields(string_view(line).substr(sp + 1))) ==
+                  OpStatus::Ok;
+        }
+    });
+    size_t hits = 0;
+    measure("scan", [&] {
+        lib.forEach([&](const LibraryItem& it) {
+            if (it.getTitle().size() > 20 && it.getAuthor()[0] == 'K') hits++;
+        });
+    });
+    measure("title lookup", [&] {
+        for (const string& t : probes) hits += lib.searchByTitle(t) != nullptr;
+    });
+    measure("jsonl dump", [&] {
+        ofstream devnull("/dev/null");
+        OutputBuffer out(devnull);
+        RecordWriter w(out, OutputFormat::Jsonl);
+        lib.forEach([&](const LibraryItem& it) {
+            w.begin();
+            it.writeFields(w);
+            w.end();
+        });
+    });
+    cout << (ok == n && hits >= n ? "" : "  UNEXPECTED RESULT\n");
+}
+
+static int runBenchmarks(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "";
+    vector<size_t> sizes;
+    for (int i = 3; i < argc; ++i) sizes.push_back((size_t)strtoull(argv[i], nullptr, 10));
+
+    if (which == "index") {
+        if (sizes.empty()) sizes = {1000000, 10000000};
+        for (size_t n : sizes) if (n > 0) benchIndex(n);
+    } else if (which == "churn") {
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchChurn(n);
+    } else if (which == "isbn") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchIsbn(n);
+    } else if (which == "overdue") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchOverdue(n);
+    } else if (which == "alloc") {
+        if (!countingAllocations()) {
+            cout << "allocation counts need a build with -DCOUNT_ALLOCATIONS\n";
+            return 1;
+        }
+        if (sizes.empty()) sizes = {1000000};
+        for (size_t n : sizes) if (n > 0) benchAlloc(n);
+    } else {
+        cout << "usage: libraryManagement --bench <index|churn|isbn|overdue|alloc> [item counts...]\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") return runBenchmarks(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            cerr << "usage: libraryManagement --batch <command file | ->\n";
+            return 1;
+        }
+        Library lib;
+        if (string(argv[2]) == "-") return runBatch(lib, cin);
+        ifstream file(argv[2]);
+        if (!file) {
+            cerr << "Cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        return runBatch(lib, file);
+    }
+
+    OutputFormat format = OutputFormat::Table;
+    if (!formatFromArgs(argc, argv, format, cout)) return 1;
+
     Library lib;
     bool running = true;
 
@@ -442,6 +1887,7 @@ int main() {
             showMenu();
             int choice;
             if (!(cin >> choice)) {
+                if (cin.eof()) break;
                 clearInput();
                 cout << "Invalid input. Please enter a numeric choice.\n";
                 continue;
@@ -459,7 +1905,7 @@ int main() {
                     addMagazineInteractive(lib);
                     break;
                 case 4:
-                    lib.displayAll();
+                    lib.displayAll(format);
                     break;
                 case 5: {
                     string title;
@@ -471,10 +1917,21 @@ int main() {
                     break;
                 }
                 case 6: {
-                    string title;
+                    string title, date;
                     cout << "Enter title to check out: ";
                     getline(cin, title);
-                    lib.checkOutItem(title);
+                    LibraryItem* it = lib.searchByTitle(title);
+                    if (!it) {
+                        cout << "Item not found.\n";
+                        break;
+                    }
+                    if (it->copiesAvailable() <= 0) {
+                        it->printCheckOut(OpStatus::Unavailable, NO_DAY);
+                        break;
+                    }
+                    cout << "Enter due date (YYYY-MM-DD, blank for " << LOAN_DAYS << " days): ";
+                    getline(cin, date);
+                    lib.checkOutItem(title, date.empty() ? today() + LOAN_DAYS : parseDate(date));
                     break;
                 }
                 case 7: {
@@ -495,6 +1952,29 @@ int main() {
                     running = false;
                     cout << "Exiting. Releasing resources...\n";
                     break;
+                case 10: {
+                    string author;
+                    cout << "Enter author to search: ";
+                    getline(cin, author);
+                    showResults(lib.searchByAuthor(author));
+                    break;
+                }
+                case 11: {
+                    string query;
+                    cout << "Enter keywords (all must match): ";
+                    getline(cin, query);
+                    showResults(lib.search(query));
+                    break;
+                }
+                case 12: {
+                    string date;
+                    cout << "Overdue as of (YYYY-MM-DD, blank for today): ";
+                    getline(cin, date);
+                    Day day = date.empty() ? today() : parseDate(date);
+                    if (day == NO_DAY) cout << "Invalid date.\n";
+                    else lib.listOverdue(day, format);
+                    break;
+                }
                 default:
                     cout << "Invalid choice. Choose again.\n";
             }
@@ -0,0 +1,288 @@
+// outputBuffer.h
+// Shared buffered output for the console programs: records are formatted into
+// a reusable byte buffer (integers and floats via std::to_chars) and handed to
+// the stream in large chunks instead of field by field.
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+enum class OutputFormat { Table, Csv, Jsonl };
+
+// value of a --format=table|csv|jsonl option
+inline bool parseOutputFormat(std::string_view value, OutputFormat& out) {
+    if (value == "table") out = OutputFormat::Table;
+    else if (value == "csv") out = OutputFormat::Csv;
+    else if (value == "jsonl") out = OutputFormat::Jsonl;
+    else return false;
+    return true;
+}
+
+// scans argv for --format=...; false (with a message) on an unknown format
+inline bool formatFromArgs(int argc, char* argv[], OutputFormat& out, std::ostream& err) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.compare(0, 9, "--format=") != 0) continue;
+        if (!parseOutputFormat(arg.substr(9), out)) {
+            err << "Unknown format \"" << arg.substr(9) << "\" (use table, csv or jsonl)\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/* OutputBuffer: append-only byte buffer in front of an ostream. Nothing is
+   allocated after construction; the buffer is written out when it fills up,
+   on flush() and on destruction. */
+class OutputBuffer {
+private:
+    std::ostream& sink;
+    std::vector<char> buf;
+    size_t len;
+
+    char* reserve(size_t n) {
+        if (len + n > buf.size()) flush();
+        return buf.data() + len;
+    }
+
+public:
+    explicit OutputBuffer(std::ostream& os, size_t capacity = 1 << 16)
+        : sink(os), buf(capacity), len(0) {}
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void flush() {
+        if (len) sink.write(buf.data(), (std::streamsize)len);
+        len = 0;
+    }
+
+    OutputBuffer& operator<<(char c) {
+        *reserve(1) = c;
+        len++;
+        return *this;
+    }
+
+    OutputBuffer& operator<<(std::string_view s) {
+        if (s.size() > buf.size()) {
+            flush();
+            sink.write(s.data(), (std::streamsize)s.size());
+        } else {
+            memcpy(reserve(s.size()), s.data(), s.size());
+            len += s.size();
+        }
+        return *this;
+    }
+
+    OutputBuffer& operator<<(const char* s) { return *this << std::string_view(s); }
+    OutputBuffer& operator<<(const std::string& s) { return *this << std::string_view(s); }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+                                !std::is_same<T, bool>::value, OutputBuffer&>::type
+    operator<<(T v) {
+        char* p = reserve(24);
+        len = std::to_chars(p, buf.data() + buf.size(), v).ptr - buf.data();
+        return *this;
+    }
+
+    // same text as an ostream with default flags (6 significant digits)
+    OutputBuffer& operator<<(double v) {
+        char* p = reserve(32);
+        len = std::to_chars(p, buf.data() + buf.size(), v, std::chars_format::general, 6).ptr - buf.data();
+        return *this;
+    }
+
+    // shortest text that parses back to exactly v
+    OutputBuffer& exact(double v) {
+        char* p = reserve(32);
+        len = std::to_chars(p, buf.data() + buf.size(), v).ptr - buf.data();
+        return *this;
+    }
+
+    // fixed-point value scaled by 10^digits, e.g. decimal(-1234, 2) -> "-12.34"
+    OutputBuffer& decimal(long long scaled, int digits) {
+        len = fixedText(reserve(48), scaled, digits) - buf.data();
+        return *this;
+    }
+
+    // writes the decimal() text plus a NUL to p (at most 48 bytes); returns the end
+    static char* fixedText(char* p, long long scaled, int digits) {
+        unsigned long long mag = scaled < 0 ? 0ull - (unsigned long long)scaled : (unsigned long long)scaled;
+        unsigned long long pow = 1;
+        for (int i = 0; i < digits; ++i) pow *= 10;
+        if (scaled < 0) *p++ = '-';
+        p = std::to_chars(p, p + 20, mag / pow).ptr;
+        if (digits > 0) {
+            *p++ = '.';
+            unsigned long long frac = mag % pow;
+            for (int i = digits - 1; i >= 0; --i, frac /= 10) p[i] = (char)('0' + frac % 10);
+            p += digits;
+        }
+        *p = '\0';
+        return p;
+    }
+};
+
+/* RecordWriter: renders records as table text, CSV or JSON lines.
+   Each field has a key (CSV column / JSON name) and a label for the table
+   layout; a null label hides the field in table mode. In CSV mode the fields
+   of a record must be emitted in column order; missing columns are left empty
+   and fields that are not columns are dropped. */
+class RecordWriter {
+private:
+    OutputBuffer& out;
+    OutputFormat fmt;
+    const char* fieldSep;   // table: between fields
+    const char* recordEnd;  // table: after the last field
+    const char* const* columns;
+    size_t columnCount;
+    size_t column; // CSV: next column to fill
+    bool first;
+
+    // CSV: pad up to the column for key; false if key is not a column
+    bool seekColumn(const char* key) {
+        size_t c = column;
+        while (c < columnCount && strcmp(columns[c], key) != 0) c++;
+        if (c == columnCount) return false;
+        for (; column < c; ++column) if (column) out << ',';
+        if (column) out << ',';
+        column++;
+        return true;
+    }
+
+    void quoted(std::string_view s) {
+        out << '"';
+        size_t run = 0;
+        for (size_t i = 0; i < s.size(); ++i) {
+            unsigned char c = (unsigned char)s[i];
+            const char* esc = nullptr;
+            char hex[7];
+            if (fmt == OutputFormat::Csv) {
+                if (c == '"') esc = "\"\"";
+            } else if (c == '"') esc = "\\\"";
+            else if (c == '\\') esc = "\\\\";
+            else if (c == '\n') esc = "\\n";
+            else if (c == '\t') esc = "\\t";
+            else if (c < 0x20) {
+                static const char digits[] = "0123456789abcdef";
+                memcpy(hex, "\\u00", 4);
+                hex[4] = digits[c >> 4];
+                hex[5] = digits[c & 15];
+                hex[6] = '\0';
+                esc = hex;
+            }
+            if (!esc) { run++; continue; }
+            out << s.substr(i - run, run) << esc;
+            run = 0;
+        }
+        out << s.substr(s.size() - run, run) << '"';
+    }
+
+    void value(int v) { out << v; }
+    void value(long long v) { out << v; }
+    void value(double v) { out.exact(v); } // exports keep full precision
+
+    template <class T>
+    void number(const char* key, const char* label, T v, const char* unit) {
+        if (fmt == OutputFormat::Table) {
+            if (!label) return;
+            if (!first) out << fieldSep;
+            out << label << ": " << v << unit;
+        } else if (fmt == OutputFormat::Csv) {
+            if (seekColumn(key)) value(v);
+        } else {
+            out << (first ? "{\"" : ",\"") << key << "\":";
+            value(v);
+        }
+        first = false;
+    }
+
+public:
+    RecordWriter(OutputBuffer& o, OutputFormat f, const char* sep = ", ", const char* end = "\n",
+                 const char* const* cols = nullptr, size_t ncols = 0)
+        : out(o), fmt(f), fieldSep(sep), recordEnd(end), columns(cols), columnCount(ncols),
+          column(0), first(true) {}
+
+    OutputFormat format() const { return fmt; }
+    bool table() const { return fmt == OutputFormat::Table; }
+    OutputBuffer& buffer() { return out; }
+
+    // CSV header row; no-op for the other formats
+    void header() {
+        if (fmt != OutputFormat::Csv) return;
+        for (size_t c = 0; c < columnCount; ++c) out << (c ? "," : "") << columns[c];
+        out << '\n';
+    }
+
+    void begin() { first = true; column = 0; }
+
+    void end() {
+        if (fmt == OutputFormat::Table) out << recordEnd;
+        else if (fmt == OutputFormat::Csv) {
+            for (; column < columnCount; ++column) if (column) out << ',';
+            out << '\n';
+        } else out << (first ? "{}\n" : "}\n");
+    }
+
+    // raw text that only appears in the table layout
+    void text(std::string_view s) { if (fmt == OutputFormat::Table) out << s; }
+
+    void field(const char* key, const char* label, std::string_view v, const char* unit = "") {
+        if (fmt == OutputFormat::Table) {
+            if (!label) return;
+            if (!first) out << fieldSep;
+            out << label << ": " << v << unit;
+        } else if (fmt == OutputFormat::Csv) {
+            if (!seekColumn(key)) return;
+            if (v.find_first_of(",\"\r\n") == std::string_view::npos) out << v;
+            else quoted(v);
+        } else {
+            out << (first ? "{\"" : ",\"") << key << "\":";
+            quoted(v);
+        }
+        first = false;
+    }
+
+    void field(const char* key, const char* label, const char* v, const char* unit = "") {
+        field(key, label, std::string_view(v), unit);
+    }
+    void field(const char* key, const char* label, const std::string& v, const char* unit = "") {
+        field(key, label, std::string_view(v), unit);
+    }
+    void field(const char* key, const char* label, long long v, const char* unit = "") {
+        number(key, label, v, unit);
+    }
+    void field(const char* key, const char* label, int v, const char* unit = "") {
+        number(key, label, v, unit);
+    }
+    void field(const char* key, const char* label, double v, const char* unit = "") {
+        number(key, label, v, unit);
+    }
+
+    // fixed-point number (e.g. money in minor units); written as a plain
+    // decimal in every format, never in floating point
+    void decimal(const char* key, const char* label, long long scaled, int digits, const char* unit = "") {
+        if (fmt == OutputFormat::Table) {
+            if (!label) return;
+            if (!first) out << fieldSep;
+            out << label << ": ";
+            out.decimal(scaled, digits) << unit;
+        } else if (fmt == OutputFormat::Csv) {
+            if (seekColumn(key)) out.decimal(scaled, digits);
+        } else {
+            out << (first ? "{\"" : ",\"") << key << "\":";
+            out.decimal(scaled, digits);
+        }
+        first = false;
+    }
+};
+
+#endif
@@ -1,39 +1,225 @@
 #include <iostream>
 #include <cstring>
 #include <limits>
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <functional>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <strings.h>
+#include "outputBuffer.h"
 using namespace std;
 
+/* StringTable: interns station names, train names and time texts. Each
+   distinct string is stored once, NUL-terminated, and named by a 32-bit
+   symbol ID, so records hold IDs and compare names as integers.
+   ID 0 is the empty string. */
+class StringTable {
+private:
+    static constexpr size_t CHUNK = 64 * 1024;
+
+    vector<const char*> texts;  // by ID
+    vector<uint32_t> lengths;
+    unordered_map<string_view, uint32_t> ids;
+    vector<unique_ptr<char[]>> chunks; // owned text, never moved once written
+    size_t chunkUsed;
+    size_t chunkBytes;
+    vector<uint32_t> foldedIds; // lowercase variant of each ID, NONE until asked for
+
+    const char* store(string_view s) {
+        size_t need = s.size() + 1;
+        if (chunks.empty() || chunkUsed + need > CHUNK) {
+            size_t size = max(CHUNK, need);
+            chunks.emplace_back(new char[size]);
+            chunkBytes += size;
+            chunkUsed = 0;
+        }
+        char* p = chunks.back().get() + chunkUsed;
+        memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        chunkUsed += need;
+        return p;
+    }
+
+    uint32_t add(const char* text, size_t len) {
+        uint32_t id = (uint32_t)texts.size();
+        texts.push_back(text);
+        lengths.push_back((uint32_t)len);
+        ids.emplace(string_view(text, len), id);
+        return id;
+    }
+
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    StringTable() : chunkUsed(0), chunkBytes(0) { intern(""); }
+
+    uint32_t intern(string_view s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        return add(store(s), s.size());
+    }
+
+    uint32_t find(string_view s) const {
+        auto it = ids.find(s);
+        return it == ids.end() ? NONE : it->second;
+    }
+
+    // ID of the ASCII-lowercased text of id, interned on first use; unknown
+    // IDs fold like their text, ""
+    uint32_t folded(uint32_t id) {
+        if (id >= texts.size()) return 0;
+        if (id >= foldedIds.size()) foldedIds.resize(texts.size(), NONE);
+        if (foldedIds[id] != NONE) return foldedIds[id];
+        string lower(text(id));
+        for (char& c : lower) c = (char)tolower((unsigned char)c);
+        uint32_t f = intern(lower);
+        if (id >= foldedIds.size()) foldedIds.resize(texts.size(), NONE);
+        foldedIds[id] = f;
+        return f;
+    }
+
+    // unknown IDs (e.g. from a damaged snapshot) read as ""
+    string_view text(uint32_t id) const {
+        return id < texts.size() ? string_view(texts[id], lengths[id]) : string_view();
+    }
+    const char* c_str(uint32_t id) const { return id < texts.size() ? texts[id] : ""; }
+
+    size_t size() const { return texts.size(); }
+    size_t textBytes(uint32_t id) const { return lengths[id] + 1; }
+
+    // approximate heap footprint: text chunks, per-ID arrays and the hash index
+    size_t memoryBytes() const {
+        return chunkBytes + texts.capacity() * sizeof(const char*) + lengths.capacity() * sizeof(uint32_t) +
+               foldedIds.capacity() * sizeof(uint32_t) +
+               ids.bucket_count() * sizeof(void*) + ids.size() * (sizeof(string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+    }
+
+    // takes IDs 1..count-1 from strings that live elsewhere (a mapped snapshot)
+    // without copying them; only valid while the table holds just ""
+    bool adopt(const char* blob, const uint32_t* offsets, size_t count) {
+        if (texts.size() != 1 || count == 0 || blob[offsets[0]] != '\0') return false;
+        texts.reserve(count);
+        lengths.reserve(count);
+        for (size_t i = 1; i < count; ++i) {
+            const char* t = blob + offsets[i];
+            add(t, strlen(t));
+        }
+        return true;
+    }
+};
+
+StringTable& symbols() {
+    static StringTable table;
+    return table;
+}
+
+// Fixed layout of one train. It is both Train's storage and the on-disk
+// record of a timetable snapshot, so it must stay trivially copyable.
+// Text fields are symbol IDs in symbols().
+struct TrainRecord {
+    int32_t trainNumber;
+    uint32_t nameId;
+    uint32_t sourceId;
+    uint32_t destinationId;
+    uint32_t timeId;
+    int32_t departure; // minutes since midnight parsed from the time text, -1 if unknown
+};
+
+void writeTrainFields(const TrainRecord& r, RecordWriter& w) {
+    const StringTable& t = symbols();
+    w.field("number", "Train Number", r.trainNumber);
+    w.field("name", "Train Name", t.text(r.nameId));
+    w.field("source", "Source", t.text(r.sourceId));
+    w.field("destination", "Destination", t.text(r.destinationId));
+    w.field("time", "Train Time", t.text(r.timeId));
+}
+
+// minutes since midnight for "10 AM", "02 PM", "9:15 pm", "10AM" or "14:30";
+// -1 if the text is not a time
+int parseTrainTime(const char* text, size_t cap) {
+    size_t n = strnlen(text, cap), i = 0;
+    auto skipSpaces = [&]() { while (i < n && text[i] == ' ') i++; };
+    auto readNumber = [&](int maxDigits, int& out) {
+        int digits = 0;
+        out = 0;
+        while (i < n && digits < maxDigits && text[i] >= '0' && text[i] <= '9') out = out * 10 + (text[i++] - '0'), digits++;
+        return digits > 0;
+    };
+    int hour, minute = 0;
+    skipSpaces();
+    if (!readNumber(2, hour)) return -1;
+    if (i < n && (text[i] == ':' || text[i] == '.')) {
+        i++;
+        if (!readNumber(2, minute) || minute > 59) return -1;
+    }
+    skipSpaces();
+    if (i < n) {
+        char c = (char)(text[i] | 0x20);
+        if ((c != 'a' && c != 'p') || i + 1 >= n || (text[i + 1] | 0x20) != 'm') return -1;
+        if (hour < 1 || hour > 12) return -1;
+        hour = hour % 12 + (c == 'p' ? 12 : 0);
+        i += 2;
+        skipSpaces();
+        if (i != n) return -1;
+    } else if (hour > 23) {
+        return -1;
+    }
+    return hour * 60 + minute;
+}
+
 class Train {
 private:
-    int  trainNumber;
-    char trainName[50];
-    char source[50];
-    char destination[50];
-    char trainTime[10];
+    TrainRecord rec;
     bool active;                 // counts only real records
 
    
-    static void copyText(char *dest, const char *src, size_t cap) {
-        if (!src) { dest[0] = '\0'; return; }
-        strncpy(dest, src, cap - 1);
-        dest[cap - 1] = '\0';
+    static uint32_t symbol(const char *text) { return text ? symbols().intern(text) : 0; }
+
+    void setTime(const char *time) {
+        rec.timeId = symbol(time);
+        rec.departure = parseTrainTime(time ? time : "", 10);
     }
 
 public:
     static int trainCount;
 
     // default: empty / inactive
-    Train() : trainNumber(0), active(false) {
-        trainName[0] = source[0] = destination[0] = trainTime[0] = '\0';
+    Train() : rec(), active(false) { rec.departure = -1; }
+
+    // a record loaded from elsewhere (e.g. a snapshot)
+    explicit Train(const TrainRecord& r) : rec(r), active(true) { trainCount++; }
+
+    Train(const Train& other) : rec(other.rec), active(other.active) {
+        if (active) trainCount++;
+    }
+
+    Train& operator=(const Train& other) {
+        if (active != other.active) trainCount += other.active ? 1 : -1;
+        rec = other.rec;
+        active = other.active;
+        return *this;
     }
 
      //an active record
     Train(int number, const char* name, const char* src, const char* dest, const char* time)
-        : trainNumber(number), active(true) {
-        copyText(trainName, name, sizeof(trainName));
-        copyText(source, src, sizeof(source));
-        copyText(destination, dest, sizeof(destination));
-        copyText(trainTime, time, sizeof(trainTime));
+        : rec(), active(true) {
+        rec.trainNumber = number;
+        rec.nameId = symbol(name);
+        rec.sourceId = symbol(src);
+        rec.destinationId = symbol(dest);
+        setTime(time);
         trainCount++;
     }
 
@@ -45,41 +231,42 @@ public:
     // encapsulated setters/getters
     void setTrainNumber(int number) { 
         if (!active) { active = true; trainCount++; }
-        trainNumber = number; 
+        rec.trainNumber = number; 
     }
     void setTrainName(const char* name) { 
         if (!active) { active = true; trainCount++; }
-        copyText(trainName, name, sizeof(trainName)); 
+        rec.nameId = symbol(name); 
     }
     void setSource(const char* src) { 
         if (!active) { active = true; trainCount++; }
-        copyText(source, src, sizeof(source)); 
+        rec.sourceId = symbol(src); 
     }
     void setDestination(const char* dest) { 
         if (!active) { active = true; trainCount++; }
-        copyText(destination, dest, sizeof(destination)); 
+        rec.destinationId = symbol(dest); 
     }
     void setTrainTime(const char* time) { 
         if (!active) { active = true; trainCount++; }
-        copyText(trainTime, time, sizeof(trainTime)); 
+        setTime(time); 
     }
 
-    int getTrainNumber() const { return trainNumber; }
-    const char* getTrainName() const { return trainName; }
-    const char* getSource() const { return source; }
-    const char* getDestination() const { return destination; }
-    const char* getTrainTime() const { return trainTime; }
+    int getTrainNumber() const { return rec.trainNumber; }
+    const char* getTrainName() const { return symbols().c_str(rec.nameId); }
+    const char* getSource() const { return symbols().c_str(rec.sourceId); }
+    const char* getDestination() const { return symbols().c_str(rec.destinationId); }
+    const char* getTrainTime() const { return symbols().c_str(rec.timeId); }
+    const TrainRecord& record() const { return rec; }
     static int getTrainCount() { return trainCount; }
 
     
     void setAll(int number, const char* name, const char* src, const char* dest, const char* time) {
         bool wasActive = active;
         if (!active) { active = true; trainCount++; }
-        trainNumber = number;
-        copyText(trainName, name, sizeof(trainName));
-        copyText(source, src, sizeof(source));
-        copyText(destination, dest, sizeof(destination));
-        copyText(trainTime, time, sizeof(trainTime));
+        rec.trainNumber = number;
+        rec.nameId = symbol(name);
+        rec.sourceId = symbol(src);
+        rec.destinationId = symbol(dest);
+        setTime(time);
         (void)wasActive; // silence unused warning if any
     }
 
@@ -107,14 +294,19 @@ public:
         setAll(number, name, src, dest, time);
     }
 
+    // one record: table rows are "Label: value" lines
+    void writeFields(RecordWriter& w) const { writeTrainFields(rec, w); }
+
     // print one train nicely
-    void displayTrainDetails(int idx = -1) const {
-        if (idx >= 0) cout << "Train " << idx << " details:\n";
-        cout << "Train Number: " << trainNumber << '\n'
-             << "Train Name: " << trainName << '\n'
-             << "Source: " << source << '\n'
-             << "Destination: " << destination << '\n'
-             << "Train Time: " << trainTime << '\n';
+    void displayTrainDetails(int idx = -1) const { displayTrainRecord(rec, idx); }
+
+    static void displayTrainRecord(const TrainRecord& r, long idx = -1) {
+        OutputBuffer out(cout, 512);
+        if (idx >= 0) out << "Train " << idx << " details:\n";
+        RecordWriter w(out, OutputFormat::Table, "\n", "\n");
+        w.begin();
+        writeTrainFields(r, w);
+        w.end();
     }
 
     bool isActive() const { return active; }
@@ -122,44 +314,363 @@ public:
 
 int Train::trainCount = 0;
 
+/* Timetable snapshot: a versioned binary image of the timetable that is
+   mmap'ed and used in place at startup, with no parsing.
+
+     SnapshotHeader (64 bytes)
+     uint32 offset x stringCount      start of each symbol in the blob
+     char blob[stringBytes]           NUL-terminated symbol texts, ID order
+     padding to 8 bytes
+     TrainRecord x recordCount
+
+   Version 2 added the string table (version 1 embedded fixed char arrays in
+   each record). The checksum covers everything after the header. Integers
+   are stored in host byte order. */
+struct SnapshotHeader {
+    char magic[8];        // "RAILSNAP"
+    uint32_t version;
+    uint32_t recordSize;  // sizeof(TrainRecord) when written
+    uint64_t recordCount;
+    uint64_t checksum;
+    uint64_t stringCount;
+    uint64_t stringBytes;
+    uint8_t reserved[16];
+};
+
+const char SNAPSHOT_MAGIC[8] = {'R', 'A', 'I', 'L', 'S', 'N', 'A', 'P'};
+const uint32_t SNAPSHOT_VERSION = 2;
+
+size_t snapshotRecordsOffset(uint64_t stringCount, uint64_t stringBytes) {
+    size_t off = sizeof(SnapshotHeader) + stringCount * sizeof(uint32_t) + stringBytes;
+    return (off + 7) & ~(size_t)7;
+}
+
+// four independent multiply-xor lanes over 8-byte words, folded at the end
+uint64_t snapshotChecksum(const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    const uint64_t K = 0x9E3779B97F4A7C15ull;
+    uint64_t h[4] = {1, 2, 3, 4};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t w;
+            memcpy(&w, p + i + 8 * l, 8);
+            h[l] = (h[l] ^ w) * K;
+            h[l] ^= h[l] >> 29;
+        }
+    }
+    uint64_t r = h[0] ^ (h[1] * 3) ^ (h[2] * 5) ^ (h[3] * 7) ^ size;
+    for (; i < size; ++i) r = (r ^ p[i]) * K;
+    return r ^ (r >> 32);
+}
+
+class TimetableSnapshot {
+private:
+    const unsigned char* base;
+    size_t length;
+    const TrainRecord* records;
+    size_t count;
+
+    TimetableSnapshot() : base(nullptr), length(0), records(nullptr), count(0) {}
+
+public:
+    ~TimetableSnapshot() { if (base) munmap((void*)base, length); }
+
+    TimetableSnapshot(const TimetableSnapshot&) = delete;
+    TimetableSnapshot& operator=(const TimetableSnapshot&) = delete;
+
+    // maps and validates path and loads its symbols into symbols(), which must
+    // still be empty; on failure returns nullptr and sets error
+    static unique_ptr<TimetableSnapshot> open(const char* path, string& error) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) { error = strerror(errno); return nullptr; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            error = "file too small for a snapshot header";
+            return nullptr;
+        }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) { error = strerror(errno); return nullptr; }
+
+        unique_ptr<TimetableSnapshot> snap(new TimetableSnapshot());
+        snap->base = (const unsigned char*)p;
+        snap->length = (size_t)st.st_size;
+
+        SnapshotHeader h;
+        memcpy(&h, p, sizeof(h));
+        if (memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) { error = "not a timetable snapshot"; return nullptr; }
+        if (h.version != SNAPSHOT_VERSION) { error = "unsupported snapshot version " + to_string(h.version); return nullptr; }
+        if (h.recordSize != sizeof(TrainRecord)) { error = "record layout mismatch"; return nullptr; }
+        if (h.stringCount == 0 || h.stringCount > 0xFFFFFFFFu || h.stringBytes > snap->length ||
+            h.recordCount > snap->length / sizeof(TrainRecord) ||
+            snapshotRecordsOffset(h.stringCount, h.stringBytes) + h.recordCount * sizeof(TrainRecord) != snap->length) {
+            error = "record count does not match file size";
+            return nullptr;
+        }
+        if (snapshotChecksum(snap->base + sizeof(h), snap->length - sizeof(h)) != h.checksum) {
+            error = "checksum mismatch";
+            return nullptr;
+        }
+        const uint32_t* offsets = (const uint32_t*)(snap->base + sizeof(h));
+        const char* blob = (const char*)(offsets + h.stringCount);
+        if (h.stringBytes == 0 || blob[h.stringBytes - 1] != '\0') { error = "damaged string table"; return nullptr; }
+        for (uint64_t i = 0; i < h.stringCount; ++i)
+            if (offsets[i] >= h.stringBytes) { error = "damaged string table"; return nullptr; }
+        snap->records = (const TrainRecord*)(snap->base + snapshotRecordsOffset(h.stringCount, h.stringBytes));
+        snap->count = (size_t)h.recordCount;
+        // the checksum only catches accidents; symbol IDs index the table
+        for (size_t i = 0; i < snap->count; ++i) {
+            const TrainRecord& r = snap->records[i];
+            if (r.nameId >= h.stringCount || r.sourceId >= h.stringCount || r.destinationId >= h.stringCount ||
+                r.timeId >= h.stringCount) {
+                error = "record " + to_string(i) + " refers to an unknown symbol";
+                return nullptr;
+            }
+        }
+        if (!symbols().adopt(blob, offsets, (size_t)h.stringCount)) {
+            error = "symbols already in use; load the snapshot first";
+            return nullptr;
+        }
+        return snap;
+    }
+
+    const TrainRecord* data() const { return records; }
+    size_t size() const { return count; }
+};
+
+// writes header, symbols and records to a temp file and renames it over path
+bool writeSnapshot(const char* path, const TrainRecord* records, size_t count, string& error) {
+    const StringTable& table = symbols();
+    vector<uint32_t> offsets(table.size());
+    size_t blobBytes = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        offsets[i] = (uint32_t)blobBytes;
+        blobBytes += table.textBytes((uint32_t)i);
+    }
+    size_t recordsAt = snapshotRecordsOffset(table.size(), blobBytes);
+
+    // body = everything after the header, built once so it can be checksummed
+    vector<char> body(recordsAt - sizeof(SnapshotHeader) + count * sizeof(TrainRecord), 0);
+    memcpy(body.data(), offsets.data(), offsets.size() * sizeof(uint32_t));
+    char* blob = body.data() + offsets.size() * sizeof(uint32_t);
+    for (size_t i = 0; i < table.size(); ++i) memcpy(blob + offsets[i], table.c_str((uint32_t)i), table.textBytes((uint32_t)i));
+    if (count) memcpy(body.data() + recordsAt - sizeof(SnapshotHeader), records, count * sizeof(TrainRecord));
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.recordSize = sizeof(TrainRecord);
+    h.recordCount = count;
+    h.stringCount = table.size();
+    h.stringBytes = blobBytes;
+    h.checksum = snapshotChecksum(body.data(), body.size());
+
+    string tmp = string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) { error = strerror(errno); return false; }
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if (ok && !body.empty()) ok = fwrite(body.data(), 1, body.size(), f) == body.size();
+    ok = (fflush(f) == 0) && ok && fsync(fileno(f)) == 0;
+    if (fclose(f) != 0) ok = false;
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        error = strerror(errno);
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+/* RouteIndex: (source, destination) -> departures sorted by time, so
+   "trains from A to B departing between t1 and t2" is a hash lookup plus a
+   binary search. Keys are the case-folded station symbols, so station names
+   match case-insensitively with integer compares. */
+class RouteIndex {
+private:
+    struct Departure {
+        int32_t minutes;  // -1 when the time text did not parse
+        uint32_t record;  // index into the timetable
+        bool operator<(const Departure& o) const {
+            return minutes != o.minutes ? minutes < o.minutes : record < o.record;
+        }
+    };
+
+    unordered_map<uint64_t, vector<Departure>> routes;
+
+    static uint64_t routeKey(uint32_t foldedSrc, uint32_t foldedDst) { return (uint64_t)foldedSrc << 32 | foldedDst; }
+
+    static uint64_t routeKey(const TrainRecord& r) {
+        StringTable& t = symbols();
+        return routeKey(t.folded(r.sourceId), t.folded(r.destinationId));
+    }
+
+    static uint32_t foldedLookup(string_view name) {
+        string lower(name);
+        for (char& c : lower) c = (char)tolower((unsigned char)c);
+        return symbols().find(lower);
+    }
+
+public:
+    // bulk load: append everything, then sort each route once
+    void build(size_t count, const function<const TrainRecord&(size_t)>& recordAt) {
+        routes.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const TrainRecord& r = recordAt(i);
+            routes[routeKey(r)].push_back(Departure{r.departure, (uint32_t)i});
+        }
+        for (auto& route : routes) sort(route.second.begin(), route.second.end());
+    }
+
+    void insert(const TrainRecord& r, size_t recordIndex) {
+        vector<Departure>& deps = routes[routeKey(r)];
+        Departure d{r.departure, (uint32_t)recordIndex};
+        deps.insert(upper_bound(deps.begin(), deps.end(), d), d);
+    }
+
+    // records departing src for dst with fromMinute <= time <= toMinute, by time;
+    // a fromMinute of -1 also includes trains whose time did not parse
+    vector<uint32_t> between(string_view src, string_view dst, int fromMinute = 0, int toMinute = 24 * 60) const {
+        vector<uint32_t> out;
+        uint32_t s = foldedLookup(src), d = foldedLookup(dst);
+        if (s == StringTable::NONE || d == StringTable::NONE) return out;
+        auto it = routes.find(routeKey(s, d));
+        if (it == routes.end()) return out;
+        const vector<Departure>& deps = it->second;
+        auto first = lower_bound(deps.begin(), deps.end(), Departure{fromMinute, 0});
+        for (auto dep = first; dep != deps.end() && dep->minutes <= toMinute; ++dep) out.push_back(dep->record);
+        return out;
+    }
+
+    size_t routeCount() const { return routes.size(); }
+};
+
 class RailwaySystem {
 private:
-    Train trains[100];
-    int totalTrains;
+    unique_ptr<TimetableSnapshot> snapshot; // read-only trains mapped from disk
+    vector<Train> trains;                   // trains added in this session
+    mutable unique_ptr<RouteIndex> routes;  // built on the first route query
+
+    const RouteIndex& routeIndex() const {
+        if (!routes) {
+            routes.reset(new RouteIndex());
+            routes->build(totalTrains(), [this](size_t i) -> const TrainRecord& { return recordAt(i); });
+        }
+        return *routes;
+    }
+
+    void added() {
+        if (routes) routes->insert(trains.back().record(), totalTrains() - 1);
+    }
+
+    size_t totalTrains() const { return (snapshot ? snapshot->size() : 0) + trains.size(); }
+
+    const TrainRecord& recordAt(size_t i) const {
+        size_t mapped = snapshot ? snapshot->size() : 0;
+        return i < mapped ? snapshot->data()[i] : trains[i - mapped].record();
+    }
 
 public:
-    RailwaySystem() : totalTrains(0) {
+    RailwaySystem() {
         //records
         addPreset(101, "Okha Express", "Surat", "Mumbai", "10 AM");
         addPreset(102, "Saurashtra Mail", "Rajkot", "Ahmedabad", "02 PM");
         addPreset(103, "Garib Rath", "Vadodara", "Delhi", "09 PM");
     }
 
+    // starts from a snapshot instead of the presets
+    explicit RailwaySystem(unique_ptr<TimetableSnapshot> snap) : snapshot(std::move(snap)) {}
+
     void addTrain() {
-        if (totalTrains >= 100) {
-            cout << "Storage full! Cannot add more trains.\n";
-            return;
+        Train t;
+        t.inputTrainDetails();
+        trains.push_back(t);
+        added();
+    }
+
+    // synthetic timetable for trying out large snapshots
+    void generate(size_t n) {
+        static const char* const stations[] = {"Surat", "Mumbai", "Rajkot", "Ahmedabad", "Vadodara", "Delhi",
+                                               "Pune", "Jaipur", "Chennai", "Kolkata", "Bhopal", "Lucknow",
+                                               "Patna", "Nagpur", "Indore", "Howrah"};
+        static const char* const kinds[] = {"Express", "Mail", "Superfast", "Rajdhani", "Shatabdi", "Passenger"};
+        trains.reserve(trains.size() + n);
+        uint32_t x = 12345;
+        char name[50], time[10];
+        for (size_t i = 0; i < n; ++i) {
+            x = x * 1664525u + 1013904223u;
+            int src = (x >> 8) % 16, dst = (src + 1 + (x >> 16) % 15) % 16;
+            int hour = (x >> 4) % 12 + 1, minute = ((x >> 20) % 4) * 15;
+            snprintf(name, sizeof(name), "%s %s", stations[src], kinds[(x >> 24) % 6]);
+            if (minute) snprintf(time, sizeof(time), "%02d:%02d %s", hour, minute, (x >> 28 & 1) ? "PM" : "AM");
+            else snprintf(time, sizeof(time), "%02d %s", hour, (x >> 28 & 1) ? "PM" : "AM");
+            trains.push_back(Train(10000 + (int)i, name, stations[src], stations[dst], time));
+            added();
         }
-        trains[totalTrains].inputTrainDetails();
-        totalTrains++;
     }
 
-    void displayAllTrains() const {
-        if (totalTrains == 0) {
-            cout << "No train records available.\n";
+    bool saveSnapshot(const char* path, string& error) const {
+        if (trains.empty() && snapshot) return writeSnapshot(path, snapshot->data(), snapshot->size(), error);
+        // Train wraps its record with a flag, so gather the records contiguously
+        vector<TrainRecord> all;
+        all.reserve(totalTrains());
+        for (size_t i = 0; i < totalTrains(); ++i) all.push_back(recordAt(i));
+        return writeSnapshot(path, all.data(), all.size(), error);
+    }
+
+    size_t size() const { return totalTrains(); }
+
+    void displayAllTrains(OutputFormat fmt = OutputFormat::Table) const {
+        static const char* const columns[] = {"number", "name", "source", "destination", "time"};
+        if (totalTrains() == 0) {
+            if (fmt == OutputFormat::Table) cout << "No train records available.\n";
             return;
         }
-        for (int i = 0; i < totalTrains; ++i) {
-            cout << "\n";
-            trains[i].displayTrainDetails(i + 1);
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, "\n", "\n", columns, 5);
+        w.header();
+        for (size_t i = 0; i < totalTrains(); ++i) {
+            if (w.table()) out << "\nTrain " << i + 1 << " details:\n";
+            w.begin();
+            writeTrainFields(recordAt(i), w);
+            w.end();
+        }
+        size_t active = Train::getTrainCount() + (snapshot ? snapshot->size() : 0);
+        if (w.table()) out << "\nTotal active trains: " << active << "\n";
+    }
+
+    vector<uint32_t> trainsBetween(string_view src, string_view dst, int fromMinute, int toMinute = 24 * 60) const {
+        return routeIndex().between(src, dst, fromMinute, toMinute);
+    }
+
+    const TrainRecord& train(size_t i) const { return recordAt(i); }
+
+    void searchRoute(const string& src, const string& dst, int fromMinute, OutputFormat fmt) const {
+        static const char* const columns[] = {"number", "name", "source", "destination", "time"};
+        vector<uint32_t> found = trainsBetween(src, dst, fromMinute);
+        OutputBuffer out(cout);
+        RecordWriter w(out, fmt, "\n", "\n", columns, 5);
+        if (w.table()) {
+            out << found.size() << " train(s) from " << src << " to " << dst;
+            if (fromMinute >= 0)
+                out << " departing at or after " << fromMinute / 600 << fromMinute / 60 % 10 << ':'
+                    << fromMinute % 60 / 10 << fromMinute % 10;
+            out << "\n";
+        }
+        w.header();
+        for (uint32_t i : found) {
+            if (w.table()) out << "\n";
+            w.begin();
+            writeTrainFields(recordAt(i), w);
+            w.end();
         }
-        cout << "\nTotal active trains: " << Train::getTrainCount() << "\n";
     }
 
     void searchTrainByNumber(int number) const {
-        for (int i = 0; i < totalTrains; ++i) {
-            if (trains[i].isActive() && trains[i].getTrainNumber() == number) {
-                trains[i].displayTrainDetails(i + 1);
+        for (size_t i = 0; i < totalTrains(); ++i) {
+            if (recordAt(i).trainNumber == number) {
+                Train::displayTrainRecord(recordAt(i), (long)i + 1);
                 return;
             }
         }
@@ -168,27 +679,176 @@ public:
 
 private:
     void addPreset(int number, const char* name, const char* src, const char* dest, const char* time) {
-        trains[totalTrains].setAll(number, name, src, dest, time);
-        totalTrains++;
+        trains.push_back(Train(number, name, src, dest, time));
+        added();
     }
 };
 
-int main() {
+// resident set size from /proc, 0 where unavailable
+size_t residentBytes() {
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long pages = 0, resident = 0;
+    int got = fscanf(f, "%lu %lu", &pages, &resident);
+    fclose(f);
+    return got == 2 ? resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+/* Benchmarks: ./railway --bench route [trains] [queries]
+               ./railway --bench memory [trains] */
+int benchMemory(size_t n) {
+    // the record layout before interning: fixed char arrays per train
+    struct LegacyTrain {
+        int trainNumber;
+        char trainName[50], source[50], destination[50], trainTime[10];
+        bool active;
+    };
+    size_t before = residentBytes();
+    auto t0 = chrono::steady_clock::now();
+    RailwaySystem system;
+    system.generate(n);
+    double genMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    size_t after = residentBytes();
+
+    double legacyPer = sizeof(LegacyTrain);
+    double tablePer = (double)symbols().memoryBytes() / n;
+    double internedPer = sizeof(Train) + tablePer;
+    cout << "trains=" << system.size() << "  symbols=" << symbols().size() << "  generate: " << genMs << " ms\n"
+         << "  fixed arrays: " << legacyPer << " bytes/record (" << legacyPer * n / 1e6 << " MB)\n"
+         << "  interned:     " << internedPer << " bytes/record (" << sizeof(Train) << " record + " << tablePer
+         << " string table; " << internedPer * n / 1e6 << " MB)\n"
+         << "  resident growth: " << (after > before ? (double)(after - before) / n : 0.0) << " bytes/record\n";
+    return 0;
+}
+
+int benchRoute(size_t n, size_t queries) {
+    static const char* const stations[] = {"Surat", "Mumbai", "Rajkot", "Ahmedabad", "Vadodara", "Delhi",
+                                           "Pune", "Jaipur", "Chennai", "Kolkata", "Bhopal", "Lucknow",
+                                           "Patna", "Nagpur", "Indore", "Howrah"};
+    RailwaySystem system;
+    system.generate(n);
+
+    auto t0 = chrono::steady_clock::now();
+    system.trainsBetween("Surat", "Mumbai", 0); // first query builds the index
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    // "from A to B departing in the hour after t"
+    mt19937 rng(9);
+    struct Query { int src, dst, from; };
+    vector<Query> qs(queries);
+    for (Query& q : qs) {
+        q.src = rng() % 16;
+        q.dst = (q.src + 1 + rng() % 15) % 16;
+        q.from = rng() % (24 * 60);
+    }
+    size_t matches = 0;
+    t0 = chrono::steady_clock::now();
+    for (const Query& q : qs) matches += system.trainsBetween(stations[q.src], stations[q.dst], q.from, q.from + 60).size();
+    double indexSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // linear scan over the timetable for a sample of the same queries
+    size_t sample = min<size_t>(queries, 200), scanMatches = 0, sampleMatches = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < sample; ++k) {
+        const Query& q = qs[k];
+        for (size_t i = 0; i < system.size(); ++i) {
+            const TrainRecord& r = system.train(i);
+            if (strcasecmp(symbols().c_str(r.sourceId), stations[q.src]) != 0 ||
+                strcasecmp(symbols().c_str(r.destinationId), stations[q.dst]) != 0) continue;
+            int m = parseTrainTime(symbols().c_str(r.timeId), 10);
+            if (m >= q.from && m <= q.from + 60) scanMatches++;
+        }
+    }
+    double scanSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    for (size_t k = 0; k < sample; ++k)
+        sampleMatches += system.trainsBetween(stations[qs[k].src], stations[qs[k].dst], qs[k].from, qs[k].from + 60).size();
+
+    cout << "trains=" << system.size() << "  index build: " << buildMs << " ms\n"
+         << "  indexed: " << queries << " queries in " << indexSec * 1000 << " ms  ("
+         << (long)(queries / indexSec) << " queries/s, " << indexSec / queries * 1e6 << " us/query, "
+         << matches << " matches)\n"
+         << "  linear scan: " << scanSec / sample * 1e6 << " us/query over " << sample << " queries  ("
+         << (scanMatches == sampleMatches ? "same" : "DIFFERENT") << " results)\n";
+    return 0;
+}
+
+int runBenchmarks(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "";
+    if (which == "route") {
+        size_t n = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1000000;
+        size_t queries = argc > 4 ? strtoull(argv[4], nullptr, 10) : 100000;
+        return benchRoute(n, queries);
+    } else if (which == "memory") {
+        return benchMemory(argc > 3 ? strtoull(argv[3], nullptr, 10) : 5000000);
+    }
+    cout << "usage: railway --bench <route|memory> [trains] [queries]\n";
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
-    RailwaySystem system;
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return runBenchmarks(argc, argv);
+
+    OutputFormat format = OutputFormat::Table;
+    if (!formatFromArgs(argc, argv, format, cout)) return 1;
+
+    // --snapshot <file>: start from a snapshot; --write-snapshot <file> [N]: write
+    // the current timetable plus N generated trains and exit
+    const char* snapshotPath = nullptr;
+    const char* writePath = nullptr;
+    size_t generateCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshotPath = argv[++i];
+        else if (strcmp(argv[i], "--write-snapshot") == 0 && i + 1 < argc) {
+            writePath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') generateCount = strtoull(argv[++i], nullptr, 10);
+        }
+    }
+
+    unique_ptr<RailwaySystem> loaded;
+    if (snapshotPath) {
+        auto t0 = chrono::steady_clock::now();
+        string error;
+        unique_ptr<TimetableSnapshot> snap = TimetableSnapshot::open(snapshotPath, error);
+        if (!snap) {
+            cout << "Cannot load snapshot " << snapshotPath << ": " << error << "\n";
+            return 1;
+        }
+        size_t n = snap->size();
+        loaded.reset(new RailwaySystem(std::move(snap)));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "Loaded " << n << " trains from " << snapshotPath << " in " << ms << " ms\n";
+    } else {
+        loaded.reset(new RailwaySystem());
+    }
+    RailwaySystem& system = *loaded;
+
+    if (writePath) {
+        system.generate(generateCount);
+        string error;
+        if (!system.saveSnapshot(writePath, error)) {
+            cout << "Cannot write snapshot " << writePath << ": " << error << "\n";
+            return 1;
+        }
+        cout << "Wrote " << system.size() << " trains to " << writePath << "\n";
+        return 0;
+    }
 
     while (true) {
         cout << "\n--- Railway Reservation System Menu ---\n";
         cout << "1. Add New Train Record\n";
         cout << "2. Display All Train Records\n";
         cout << "3. Search Train by Number\n";
-        cout << "4. Exit\n";
+        cout << "4. Find Trains by Route\n";
+        cout << "5. Save Timetable Snapshot\n";
+        cout << "6. Exit\n";
         cout << "Enter your choice: ";
 
         int choice;
         if (!(cin >> choice)) {
+            if (cin.eof()) break;
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             cout << "Invalid choice.\n";
@@ -199,7 +859,7 @@ int main() {
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             system.addTrain();
         } else if (choice == 2) {
-            system.displayAllTrains();
+            system.displayAllTrains(format);
         } else if (choice == 3) {
             cout << "Enter Train Number to search: ";
             int num;
@@ -211,10 +871,29 @@ int main() {
                 cout << "Invalid train number.\n";
             }
         } else if (choice == 4) {
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            string src, dst, after;
+            cout << "Source: ";
+            getline(cin, src);
+            cout << "Destination: ";
+            getline(cin, dst);
+            cout << "Departing after (e.g. 09:00 or 2 PM, blank for any): ";
+            getline(cin, after);
+            int from = after.empty() ? -1 : parseTrainTime(after.c_str(), after.size());
+            if (!after.empty() && from < 0) cout << "Invalid time.\n";
+            else system.searchRoute(src, dst, from, format);
+        } else if (choice == 5) {
+            cout << "Snapshot file: ";
+            string path;
+            cin >> path;
+            string error;
+            if (system.saveSnapshot(path.c_str(), error)) cout << "Saved " << system.size() << " trains to " << path << ".\n";
+            else cout << "Cannot write snapshot: " << error << "\n";
+        } else if (choice == 6) {
             cout << "Exiting the system. Goodbye!\n";
             break;
         } else {
-            cout << "Please choose 1-4.\n";
+            cout << "Please choose 1-6.\n";
         }
     }
     return 0;
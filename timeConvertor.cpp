@@ -1,6 +1,143 @@
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "outputBuffer.h"
 using namespace std;
 
+// Division by the constant unit sizes as multiply-shift (checked for every
+// input in range):
+// x / 3600 for any 32-bit x, as (x >> 4) / 225 in 36-bit fixed point
+constexpr uint32_t div3600(uint32_t x) { return (uint32_t)(((uint64_t)(x >> 4) * 305419897u) >> 36); }
+// x / 60 for x < 3600
+constexpr uint32_t div60(uint32_t x) { return (x * 2185u) >> 17; }
+
+#if defined(__SSE2__)
+// div3600 on four lanes: pmuludq covers lanes 0 and 2, then 1 and 3
+static inline __m128i div3600x4(__m128i x) {
+    const __m128i magic = _mm_set1_epi32(305419897);
+    __m128i q = _mm_srli_epi32(x, 4);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(q, magic), 36);
+    __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(q, 32), magic), 36);
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+// x * 3600 on four lanes (3600 = 4096 - 512 + 16)
+static inline __m128i mul3600x4(__m128i x) {
+    return _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(x, 12), _mm_slli_epi32(x, 9)), _mm_slli_epi32(x, 4));
+}
+#endif
+
+// Clock text. Everything below is constexpr so that conversions of constants
+// fold at compile time; at run time the digits come two at a time from a
+// 200-byte table instead of a division per digit.
+
+// "00".."99" back to back; the pair for v starts at 2 * v
+struct DigitPairs {
+    char text[200];
+    constexpr DigitPairs() : text() {
+        for (int i = 0; i < 100; ++i) {
+            text[2 * i] = (char)('0' + i / 10);
+            text[2 * i + 1] = (char)('0' + i % 10);
+        }
+    }
+};
+constexpr DigitPairs DIGIT_PAIRS;
+
+// longest text formatHHMMSS writes (UINT32_MAX seconds): "1193046:28:15"
+const size_t HHMMSS_MAX = 13;
+const uint32_t MAX_HOURS = 1193046;
+
+constexpr char* putPair(char* p, uint32_t v) {
+    p[0] = DIGIT_PAIRS.text[2 * v];
+    p[1] = DIGIT_PAIRS.text[2 * v + 1];
+    return p + 2;
+}
+
+// writes "HH:MM:SS" (hours widen past two digits as needed, no NUL) for
+// m, s < 60; returns the end
+constexpr char* formatClock(char* p, uint32_t h, uint32_t m, uint32_t s) {
+    if (h < 100) p = putPair(p, h);
+    else {
+        size_t digits = 3;
+        for (uint32_t x = h / 1000; x; x /= 10) digits++;
+        char* q = p + digits;
+        for (; h >= 100; h /= 100) q = putPair(q - 2, h % 100) - 2;
+        if (h >= 10) putPair(q - 2, h);
+        else q[-1] = (char)('0' + h);
+        p += digits;
+    }
+    p[0] = ':';
+    putPair(p + 1, m);
+    p[3] = ':';
+    putPair(p + 4, s);
+    return p + 6;
+}
+
+constexpr char* formatHHMMSS(char* p, uint32_t total) {
+    uint32_t h = div3600(total), rem = total - h * 3600, m = div60(rem);
+    return formatClock(p, h, m, rem - m * 60);
+}
+
+// formatHHMMSS by value, for constants
+struct ClockText {
+    char text[HHMMSS_MAX];
+    size_t len;
+    constexpr string_view view() const { return string_view(text, len); }
+};
+
+constexpr ClockText clockText(uint32_t total) {
+    ClockText c{};
+    c.len = (size_t)(formatHHMMSS(c.text, total) - c.text);
+    return c;
+}
+
+// "H:MM:SS": one or more hour digits, minutes and seconds as two digits each
+// in 00..59, and a total that fits in 32 bits. Signs, blanks and missing or
+// extra fields are rejected; total is only written on success.
+constexpr bool parseHHMMSS(string_view t, uint32_t& total) {
+    size_t n = t.size();
+    if (n < 7 || t[n - 6] != ':' || t[n - 3] != ':') return false;
+    uint32_t h = 0;
+    for (size_t i = 0; i < n - 6; ++i) {
+        uint32_t d = (uint32_t)(unsigned char)t[i] - '0';
+        if (d > 9) return false;
+        h = h * 10 + d;
+        if (h > MAX_HOURS) return false;
+    }
+    uint32_t mt = (uint32_t)(unsigned char)t[n - 5] - '0', mo = (uint32_t)(unsigned char)t[n - 4] - '0';
+    uint32_t st = (uint32_t)(unsigned char)t[n - 2] - '0', so = (uint32_t)(unsigned char)t[n - 1] - '0';
+    if (mt > 5 || mo > 9 || st > 5 || so > 9) return false;
+    uint64_t sum = (uint64_t)h * 3600 + (mt * 10 + mo) * 60 + st * 10 + so;
+    if (sum > 0xFFFFFFFFu) return false;
+    total = (uint32_t)sum;
+    return true;
+}
+
+constexpr uint32_t parsedOr(string_view t, uint32_t fallback) {
+    uint32_t v = 0;
+    return parseHHMMSS(t, v) ? v : fallback;
+}
+
+static_assert(clockText(3723).view() == "01:02:03", "two-digit fields");
+static_assert(clockText(0xFFFFFFFFu).view() == "1193046:28:15", "widest hours");
+static_assert(parsedOr("1193046:28:15", 0) == 0xFFFFFFFFu, "largest total");
+static_assert(parsedOr("1193046:28:16", 0) == 0 && parsedOr("1:60:00", 0) == 0 && parsedOr("01:5:03", 0) == 0,
+              "out of range or malformed");
+
 // --------------------
 // Class Declaration
 // --------------------
@@ -8,37 +145,421 @@ class TimeConverter {
 public:
     // Function to convert seconds to HH:MM:SS
     void secondsToHHMMSS(int totalSeconds) {
-        int hours, minutes, seconds;
+        char text[HHMMSS_MAX + 1];
+        char* p = text;
+        if (totalSeconds < 0) *p++ = '-';
+        uint32_t magnitude = totalSeconds < 0 ? 0u - (uint32_t)totalSeconds : (uint32_t)totalSeconds;
+        p = formatHHMMSS(p, magnitude);             // 1 hour = 3600 s, 1 minute = 60 s
 
-        hours = totalSeconds / 3600;               // 1 hour = 3600 seconds
-        totalSeconds = totalSeconds % 3600;        // remaining seconds
-
-        minutes = totalSeconds / 60;               // 1 minute = 60 seconds
-        seconds = totalSeconds % 60;               // remaining seconds
-
-        cout << "HH:MM:SS => " << hours << ":" << minutes << ":" << seconds << endl;
+        cout << "HH:MM:SS => " << string_view(text, (size_t)(p - text)) << '\n';
     }
 
     // Function to convert HH:MM:SS to total seconds
     void HHMMSSToSeconds(int h, int m, int s) {
         int totalSeconds = (h * 3600) + (m * 60) + s;
-        cout << "Total seconds: " << totalSeconds << endl;
+        cout << "Total seconds: " << totalSeconds << '\n';
+    }
+
+    // Function to convert "HH:MM:SS" text to total seconds
+    void HHMMSSToSeconds(string_view text) {
+        uint32_t totalSeconds;
+        if (parseHHMMSS(text, totalSeconds)) cout << "Total seconds: " << totalSeconds << '\n';
+        else cout << "Invalid time \"" << text << "\" (expected HH:MM:SS, minutes and seconds 00-59)" << '\n';
+    }
+
+    // Batch conversion over n values: total seconds <-> hours, minutes and
+    // seconds columns (8 values per step with SSE2)
+    static void split(const uint32_t* total, size_t n, uint32_t* h, uint8_t* m, uint8_t* s) {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i sixty = _mm_set1_epi16(60), magic60 = _mm_set1_epi16((short)34953);
+        for (; i + 8 <= n; i += 8) {
+            __m128i x0 = _mm_loadu_si128((const __m128i*)(total + i));
+            __m128i x1 = _mm_loadu_si128((const __m128i*)(total + i + 4));
+            __m128i h0 = div3600x4(x0), h1 = div3600x4(x1);
+            _mm_storeu_si128((__m128i*)(h + i), h0);
+            _mm_storeu_si128((__m128i*)(h + i + 4), h1);
+            // remainders (< 3600) as eight 16-bit lanes; r / 60 = (r * 34953) >> 21
+            __m128i r = _mm_packs_epi32(_mm_sub_epi32(x0, mul3600x4(h0)), _mm_sub_epi32(x1, mul3600x4(h1)));
+            __m128i mins = _mm_srli_epi16(_mm_mulhi_epu16(r, magic60), 5);
+            __m128i secs = _mm_sub_epi16(r, _mm_mullo_epi16(mins, sixty));
+            _mm_storel_epi64((__m128i*)(m + i), _mm_packus_epi16(mins, mins));
+            _mm_storel_epi64((__m128i*)(s + i), _mm_packus_epi16(secs, secs));
+        }
+#endif
+        for (; i < n; ++i) {
+            uint32_t hours = div3600(total[i]);
+            uint32_t rem = total[i] - hours * 3600;
+            h[i] = hours;
+            m[i] = (uint8_t)div60(rem);
+            s[i] = (uint8_t)(rem - m[i] * 60);
+        }
+    }
+
+    // h * 3600 + m * 60 + s, modulo 2^32
+    static void join(const uint32_t* h, const uint8_t* m, const uint8_t* s, size_t n, uint32_t* total) {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128(), sixty = _mm_set1_epi16(60);
+        for (; i + 8 <= n; i += 8) {
+            __m128i mins = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(m + i)), zero);
+            __m128i secs = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s + i)), zero);
+            __m128i r = _mm_add_epi16(_mm_mullo_epi16(mins, sixty), secs);
+            __m128i h0 = _mm_loadu_si128((const __m128i*)(h + i));
+            __m128i h1 = _mm_loadu_si128((const __m128i*)(h + i + 4));
+            _mm_storeu_si128((__m128i*)(total + i), _mm_add_epi32(mul3600x4(h0), _mm_unpacklo_epi16(r, zero)));
+            _mm_storeu_si128((__m128i*)(total + i + 4), _mm_add_epi32(mul3600x4(h1), _mm_unpackhi_epi16(r, zero)));
+        }
+#endif
+        for (; i < n; ++i) total[i] = h[i] * 3600u + m[i] * 60u + s[i];
     }
 };
 
+/* Streaming mode: whitespace-separated second counts in, one "HH:MM:SS" line
+   out per value (hours widen past two digits as needed). Input is read in
+   1 MB blocks and converted in batches with TimeConverter::split; tokens that
+   are not a 32-bit unsigned number produce an "invalid" line. */
+// bitmask of the bytes <= ' ' (whitespace and control bytes) among the 16 at p
+static inline uint32_t blanksIn(const char* p) {
+#if defined(__SSE2__)
+    __m128i c = _mm_loadu_si128((const __m128i*)p);
+    const __m128i space = _mm_set1_epi8(' ');
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(c, space), space));
+#else
+    uint32_t m = 0;
+    for (int i = 0; i < 16; ++i) m |= (uint32_t)((unsigned char)p[i] <= ' ') << i;
+    return m;
+#endif
+}
+
+// value of the 1..8 digit characters at p (8 bytes readable); false if any
+// byte is not a digit. SWAR: subtract '0' from all eight bytes, shift the
+// digits to the top so the unused low bytes act as leading zeros, then fold
+// pairs, quads and halves.
+static inline bool digits8(const char* p, size_t len, uint32_t& out) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    x -= 0x3030303030303030ull;
+    x <<= 8 * (8 - len);
+    // a byte is a digit if it is < 10 after the subtraction (no borrow, no high bit)
+    if (((x | (x + 0x7676767676767676ull)) & 0x8080808080808080ull) != 0) return false;
+    x = ((x * 10) + (x >> 8)) & 0x00FF00FF00FF00FFull;
+    x = ((x * 100) + (x >> 16)) & 0x0000FFFF0000FFFFull;
+    x = (x * 10000) + (x >> 32);
+    out = (uint32_t)x;
+    return true;
+}
+
+struct StreamStats {
+    size_t values;
+    size_t invalid;
+    size_t bytesIn;
+};
+
+static StreamStats streamSeconds(FILE* in, OutputBuffer& out) {
+    const size_t BLOCK = 1 << 20, BATCH = 4096;
+    vector<char> buf(BLOCK + 16); // 16 bytes of slack for the vector reads
+    vector<uint32_t> total(BATCH), hours(BATCH);
+    vector<uint8_t> mins(BATCH), secs(BATCH), bad(BATCH);
+    vector<char> text(BATCH * 20);
+    StreamStats st = {0, 0, 0};
+    size_t pending = 0;
+
+    auto flushBatch = [&]() {
+        TimeConverter::split(total.data(), pending, hours.data(), mins.data(), secs.data());
+        char* p = text.data();
+        for (size_t i = 0; i < pending; ++i) {
+            if (bad[i]) {
+                memcpy(p, "invalid\n", 8);
+                p += 8;
+                continue;
+            }
+            p = formatClock(p, hours[i], mins[i], secs[i]);
+            *p++ = '\n';
+        }
+        out << string_view(text.data(), (size_t)(p - text.data()));
+        pending = 0;
+    };
+
+    size_t carry = 0; // bytes of an unfinished token at the start of buf
+    for (;;) {
+        size_t got = fread(buf.data() + carry, 1, BLOCK - carry, in);
+        st.bytesIn += got;
+        bool last = got == 0;
+        size_t len = carry + got;
+        memset(buf.data() + len, ' ', 16); // tokens end at len
+        const char* b = buf.data();
+        size_t i = 0;
+        for (;;) {
+            // token boundaries 16 bytes at a time
+            uint32_t m;
+            // i < len first: only b[0, len + 16) is readable
+            while (i < len && (m = ~blanksIn(b + i) & 0xFFFF) == 0) i += 16;
+            if (i >= len) break;
+            i += __builtin_ctz(m);
+            if (i >= len) break;
+            size_t start = i;
+            while ((m = blanksIn(b + i)) == 0) i += 16;
+            i += __builtin_ctz(m);
+            if (i >= len && !last && start > 0) { // may continue in the next block
+                i = start;
+                break;
+            }
+            uint32_t v = 0;
+            bool ok;
+            if (i - start <= 8) ok = digits8(b + start, i - start, v);
+            else {
+                uint64_t wide = 0;
+                ok = i - start <= 10;
+                for (size_t k = start; k < i && ok; ++k) {
+                    unsigned d = (unsigned char)b[k] - '0';
+                    ok = d < 10;
+                    wide = wide * 10 + d;
+                }
+                ok = ok && wide <= 0xFFFFFFFFu;
+                v = (uint32_t)wide;
+            }
+            total[pending] = ok ? v : 0;
+            bad[pending] = !ok;
+            st.values++;
+            st.invalid += !ok;
+            if (++pending == BATCH) flushBatch();
+        }
+        if (last) break;
+        i = min(i, len);
+        carry = len - i;
+        memmove(buf.data(), buf.data() + i, carry);
+    }
+    flushBatch();
+    return st;
+}
+
+// Benchmarks (run with --bench <name>)
+
+static double secondsSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// per-value division as in secondsToHHMMSS vs multiply-shift vs the batch kernels
+static void benchSplit(size_t n) {
+    mt19937 rng(17);
+    vector<uint32_t> total(n), back(n), h(n);
+    vector<uint8_t> m(n), s(n);
+    for (size_t i = 0; i < n; ++i) total[i] = rng() % (1000u * 3600u); // durations up to 1000 h
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        int t = (int)total[i];
+        h[i] = t / 3600;
+        t %= 3600;
+        m[i] = (uint8_t)(t / 60);
+        s[i] = (uint8_t)(t % 60);
+    }
+    double divSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t hours = div3600(total[i]), rem = total[i] - hours * 3600;
+        h[i] = hours;
+        m[i] = (uint8_t)div60(rem);
+        s[i] = (uint8_t)(rem - m[i] * 60);
+    }
+    double shiftSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    TimeConverter::split(total.data(), n, h.data(), m.data(), s.data());
+    double splitSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    TimeConverter::join(h.data(), m.data(), s.data(), n, back.data());
+    double joinSec = secondsSince(t0);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < n; ++i) wrong += back[i] != total[i] || m[i] > 59 || s[i] > 59;
+    cout << "values=" << n << "\n"
+         << "  / and % (int):        " << (long)(n / divSec) << " conversions/s\n"
+         << "  multiply-shift:       " << (long)(n / shiftSec) << " conversions/s\n"
+         << "  split (batch):        " << (long)(n / splitSec) << " conversions/s\n"
+         << "  join (batch):         " << (long)(n / joinSec) << " conversions/s"
+         << (wrong ? "  ROUND TRIP FAILED" : "  (round trip exact)") << "\n";
+}
+
+// text in, text out: n random second counts through streamSeconds
+static void benchStream(size_t n) {
+    mt19937 rng(5);
+    string input;
+    input.reserve(n * 8);
+    char num[16];
+    for (size_t i = 0; i < n; ++i) {
+        input.append(num, to_chars(num, num + 16, rng() % 86400u).ptr - num);
+        input += '\n';
+    }
+    FILE* in = fmemopen(&input[0], input.size(), "r");
+    ofstream sink("/dev/null");
+    OutputBuffer out(sink, 1 << 20);
+    auto t0 = chrono::steady_clock::now();
+    StreamStats st = streamSeconds(in, out);
+    out.flush();
+    double sec = secondsSince(t0);
+    fclose(in);
+    cout << "values=" << st.values << "  stream: " << (long)(st.values / sec) << " conversions/s  "
+         << (long)(st.bytesIn / sec / 1e6) << " MB/s in, " << (long)(st.values * 9 / sec / 1e6) << " MB/s out\n";
+}
+
+// n clock texts (durations under a day, so strftime applies) written and read
+// back by each method; every method must produce the same bytes and values
+static void benchFormat(size_t n) {
+    mt19937 rng(20);
+    vector<uint32_t> total(n), back(n);
+    for (size_t i = 0; i < n; ++i) total[i] = rng() % 86400u;
+    const size_t LINE = 9; // "HH:MM:SS\n"
+    string expect(n * LINE, '\0'), got(n * LINE + 16, '\0'); // room for a trailing NUL
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        char* p = formatHHMMSS(&expect[i * LINE], total[i]);
+        *p = '\n';
+    }
+    double lutSec = secondsSince(t0);
+
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t t = total[i];
+        snprintf(&got[i * LINE], 16, "%02u:%02u:%02u\n", t / 3600, t / 60 % 60, t % 60);
+    }
+    double snprintfSec = secondsSince(t0);
+    bool same = got.compare(0, n * LINE, expect) == 0;
+
+    t0 = chrono::steady_clock::now();
+    struct tm tm = {};
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t t = total[i];
+        tm.tm_hour = (int)(t / 3600);
+        tm.tm_min = (int)(t / 60 % 60);
+        tm.tm_sec = (int)(t % 60);
+        strftime(&got[i * LINE], 16, "%H:%M:%S\n", &tm);
+    }
+    double strftimeSec = secondsSince(t0);
+    same = same && got.compare(0, n * LINE, expect) == 0;
+
+    t0 = chrono::steady_clock::now();
+    ostringstream os;
+    os << setfill('0');
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t t = total[i];
+        os << setw(2) << t / 3600 << ':' << setw(2) << t / 60 % 60 << ':' << setw(2) << t % 60 << '\n';
+    }
+    string streamed = os.str();
+    double iostreamSec = secondsSince(t0);
+    same = same && streamed == expect;
+
+    // parsing the same text back
+    size_t wrong = 0;
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t v = 0;
+        if (!parseHHMMSS(string_view(&expect[i * LINE], LINE - 1), v)) v = ~0u;
+        back[i] = v;
+    }
+    double parseSec = secondsSince(t0);
+    for (size_t i = 0; i < n; ++i) wrong += back[i] != total[i];
+
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        string line = expect.substr(i * LINE, LINE - 1);
+        back[i] = (uint32_t)(stoi(line.substr(0, 2)) * 3600 + stoi(line.substr(3, 2)) * 60 + stoi(line.substr(6, 2)));
+    }
+    double stoiSec = secondsSince(t0);
+    for (size_t i = 0; i < n; ++i) wrong += back[i] != total[i];
+
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        unsigned h = 0, m = 0, s = 0;
+        char line[LINE];
+        memcpy(line, &expect[i * LINE], LINE - 1); // sscanf would strlen the whole rest
+        line[LINE - 1] = '\0';
+        sscanf(line, "%u:%u:%u", &h, &m, &s);
+        back[i] = h * 3600 + m * 60 + s;
+    }
+    double sscanfSec = secondsSince(t0);
+    for (size_t i = 0; i < n; ++i) wrong += back[i] != total[i];
+
+    t0 = chrono::steady_clock::now();
+    istringstream is(expect);
+    for (size_t i = 0; i < n; ++i) {
+        unsigned h = 0, m = 0, s = 0;
+        char c1, c2;
+        is >> h >> c1 >> m >> c2 >> s;
+        back[i] = h * 3600 + m * 60 + s;
+    }
+    double istreamSec = secondsSince(t0);
+    for (size_t i = 0; i < n; ++i) wrong += back[i] != total[i];
+
+    auto rate = [n](double sec) { return (long)(n / sec); };
+    cout << "values=" << n << "\n"
+         << "  format  table:        " << rate(lutSec) << "/s\n"
+         << "          snprintf:     " << rate(snprintfSec) << "/s\n"
+         << "          strftime:     " << rate(strftimeSec) << "/s\n"
+         << "          ostream:      " << rate(iostreamSec) << "/s" << (same ? "  (identical text)" : "  TEXT DIFFERS") << "\n"
+         << "  parse   parseHHMMSS:  " << rate(parseSec) << "/s\n"
+         << "          stoi:         " << rate(stoiSec) << "/s\n"
+         << "          sscanf:       " << rate(sscanfSec) << "/s\n"
+         << "          istream:      " << rate(istreamSec) << "/s" << (wrong ? "  VALUES DIFFER" : "  (all values match)") << "\n";
+}
+
+static int runBenchmarks(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "";
+    vector<size_t> sizes;
+    for (int i = 3; i < argc; ++i) sizes.push_back((size_t)strtoull(argv[i], nullptr, 10));
+
+    if (which == "split") {
+        if (sizes.empty()) sizes = {50000000};
+        for (size_t n : sizes) if (n > 0) benchSplit(n);
+    } else if (which == "stream") {
+        if (sizes.empty()) sizes = {20000000};
+        for (size_t n : sizes) if (n > 0) benchStream(n);
+    } else if (which == "format") {
+        if (sizes.empty()) sizes = {10000000};
+        for (size_t n : sizes) if (n > 0) benchFormat(n);
+    } else {
+        cout << "usage: timeConvertor --bench <split|stream|format> [value counts...]\n";
+        return 1;
+    }
+    return 0;
+}
+
 // --------------------
 // Main Function
 // --------------------
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") return runBenchmarks(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--stream") {
+        FILE* in = argc > 2 && string(argv[2]) != "-" ? fopen(argv[2], "rb") : stdin;
+        if (!in) {
+            cerr << "Cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        ios::sync_with_stdio(false);
+        StreamStats st;
+        {
+            OutputBuffer out(cout, 1 << 20);
+            st = streamSeconds(in, out);
+        }
+        if (in != stdin) fclose(in);
+        if (st.invalid) cerr << st.invalid << " of " << st.values << " values were not valid second counts\n";
+        return st.invalid ? 2 : 0;
+    }
+
     TimeConverter tc;  // create object of class
     int choice;
 
-    cout << "==============================" << endl;
-    cout << "      TIME CONVERTER MENU     " << endl;
-    cout << "==============================" << endl;
-    cout << "1. Convert Seconds to HH:MM:SS" << endl;
-    cout << "2. Convert HH:MM:SS to Seconds" << endl;
-    cout << "3. Exit" << endl;
+    cout << "==============================" << '\n';
+    cout << "      TIME CONVERTER MENU     " << '\n';
+    cout << "==============================" << '\n';
+    cout << "1. Convert Seconds to HH:MM:SS" << '\n';
+    cout << "2. Convert HH:MM:SS to Seconds" << '\n';
+    cout << "3. Convert HH:MM:SS text to Seconds" << '\n';
+    cout << "4. Exit" << '\n';
 
     cout << "\nEnter your choice: ";
     cin >> choice;
@@ -62,11 +583,18 @@ int main() {
             tc.HHMMSSToSeconds(h, m, s);
             break;
         }
-        case 3:
-            cout << "Exiting program... Goodbye!" << endl;
+        case 3: {
+            string text;
+            cout << "Enter time (HH:MM:SS): ";
+            cin >> text;
+            tc.HHMMSSToSeconds(text);
+            break;
+        }
+        case 4:
+            cout << "Exiting program... Goodbye!" << '\n';
             break;
         default:
-            cout << "Invalid choice! Please run the program again." << endl;
+            cout << "Invalid choice! Please run the program again." << '\n';
     }
 
     return 0;